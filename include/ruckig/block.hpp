@@ -131,6 +131,17 @@ public:
         return false;
     }
 
+    //! Mirror all profiles, so that the block corresponds to the mirrored (negated) input with mirrored limits
+    void mirror() {
+        p_min.mirror();
+        if (a) {
+            a->profile.mirror();
+        }
+        if (b) {
+            b->profile.mirror();
+        }
+    }
+
     inline bool is_blocked(double t) const {
         return (t < t_min) || (a && a->left < t && t < a->right) || (b && b->left < t && t < b->right);
     }
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <ruckig/block.hpp>
+
+
+namespace ruckig {
+
+//! Direct-mapped cache of Step 1 results, keyed bitwise on the exact input of a single DoF
+class BlockCache {
+public:
+    //! Current state, target state, and kinematic limits (p0, v0, a0, pf, vf, af, vMax, vMin, aMax, aMin, jMax)
+    using Key = std::array<double, 11>;
+
+private:
+    struct Entry {
+        Key key;
+        Block block;
+        bool valid {false};
+    };
+
+    std::vector<Entry> entries;
+
+    static size_t hash(const Key& key) {
+        uint64_t h {14695981039346656037ULL};
+        for (const double value: key) {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            h = (h ^ bits) * 1099511628211ULL;
+            h ^= h >> 32;
+        }
+        return static_cast<size_t>(h);
+    }
+
+public:
+    //! Number of lookups that were served from the cache
+    size_t hits {0};
+
+    //! Number of lookups that needed a new calculation
+    size_t misses {0};
+
+    explicit BlockCache(size_t capacity = 0): entries(capacity) { }
+
+    //! Number of cached blocks. A capacity of zero disables the cache. Allocates memory, so call this outside the real-time loop.
+    void resize(size_t capacity) {
+        entries.assign(capacity, Entry());
+        hits = 0;
+        misses = 0;
+    }
+
+    size_t capacity() const {
+        return entries.size();
+    }
+
+    void clear() {
+        for (auto& entry: entries) {
+            entry.valid = false;
+        }
+        hits = 0;
+        misses = 0;
+    }
+
+    double hit_rate() const {
+        return (hits + misses > 0) ? static_cast<double>(hits) / (hits + misses) : 0.0;
+    }
+
+    //! Returns the cached block for the key, or nullptr if it is not cached
+    const Block* find(const Key& key) {
+        if (entries.empty()) {
+            return nullptr;
+        }
+
+        const Entry& entry = entries[hash(key) % entries.size()];
+        if (entry.valid && std::memcmp(entry.key.data(), key.data(), sizeof(Key)) == 0) {
+            hits += 1;
+            return &entry.block;
+        }
+
+        misses += 1;
+        return nullptr;
+    }
+
+    //! Insert a block, overwriting any previous entry in its slot. Never allocates.
+    void insert(const Key& key, const Block& block) {
+        if (entries.empty()) {
+            return;
+        }
+
+        Entry& entry = entries[hash(key) % entries.size()];
+        entry.key = key;
+        entry.block = block;
+        entry.valid = true;
+    }
+};
+
+} // namespace ruckig
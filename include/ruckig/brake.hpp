@@ -69,6 +69,16 @@ public:
         v[0] = vs;
         std::tie(ps, vs, as) = integrate(t[0], ps, vs, a[0], 0.0);
     }
+
+    //! Negate the kinematic state, so that the brake corresponds to the mirrored (negated) input
+    void mirror() {
+        for (size_t i = 0; i < 2; ++i) {
+            j[i] = -j[i];
+            a[i] = -a[i];
+            v[i] = -v[i];
+            p[i] = -p[i];
+        }
+    }
 };
 
 } // namespace ruckig
@@ -2,18 +2,25 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <optional>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include <ruckig/block.hpp>
+#include <ruckig/block_cache.hpp>
 #include <ruckig/brake.hpp>
 #include <ruckig/error.hpp>
+#include <ruckig/family_statistics.hpp>
 #include <ruckig/input_parameter.hpp>
+#include <ruckig/limit_set.hpp>
 #include <ruckig/profile.hpp>
 #include <ruckig/position.hpp>
+#include <ruckig/sensitivity.hpp>
 #include <ruckig/trajectory.hpp>
 #include <ruckig/velocity.hpp>
 
@@ -35,26 +42,136 @@ private:
     StandardVectorIntervals<size_t> idx;
 
     StandardVector<Block, DOFs> blocks;
-    StandardVector<double, DOFs> inp_min_velocity, inp_min_acceleration;
 
-    StandardVector<ControlInterface, DOFs> inp_per_dof_control_interface;
-    StandardVector<Synchronization, DOFs> inp_per_dof_synchronization;
+    //! Hash of the input of the blocks after a successful Step 1, as Step 2 from the kept blocks is only valid for the same input
+    std::optional<size_t> blocks_input_hash;
+
+    //! Hash of all input parameters that Step 1 and Step 2 depend on, except the minimum duration
+    static size_t hash_input(const InputParameter<DOFs, CustomVector>& inp) {
+        uint64_t h {14695981039346656037ULL};
+        auto add = [&h](double value) {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            h = (h ^ bits) * 1099511628211ULL;
+            h ^= h >> 32;
+        };
+
+        add(static_cast<double>(inp.duration_discretization));
+        for (size_t dof = 0; dof < inp.degrees_of_freedom; ++dof) {
+            add(inp.current_position[dof]);
+            add(inp.current_velocity[dof]);
+            add(inp.current_acceleration[dof]);
+            add(inp.target_position[dof]);
+            add(inp.target_velocity[dof]);
+            add(inp.target_acceleration[dof]);
+            add(inp.max_velocity[dof]);
+            add(inp.max_acceleration[dof]);
+            add(inp.max_jerk[dof]);
+            add(inp.min_velocity ? inp.min_velocity.value()[dof] : -inp.max_velocity[dof]);
+            add(inp.min_acceleration ? inp.min_acceleration.value()[dof] : -inp.max_acceleration[dof]);
+            add(inp.enabled[dof] ? 1.0 : 0.0);
+            add(static_cast<double>(inp.per_dof_control_interface ? inp.per_dof_control_interface.value()[dof] : inp.control_interface));
+            add(static_cast<double>(inp.per_dof_synchronization ? inp.per_dof_synchronization.value()[dof] : inp.synchronization));
+            add(inp.per_dof_synchronization_group ? static_cast<double>(inp.per_dof_synchronization_group.value()[dof]) : -1.0);
+        }
+        return static_cast<size_t>(h);
+    }
+
+    bool has_blocks_of(const InputParameter<DOFs, CustomVector>& inp) const {
+        return blocks_input_hash && blocks_input_hash.value() == hash_input(inp);
+    }
+
+    //! Indices of the enabled DoFs, so that the hot loops skip disabled DoFs
+    StandardVector<size_t, DOFs> active_dofs;
+    size_t number_of_active_dofs {0};
+
+    //! For each DoF, a previous DoF with an identical or mirrored (negated) problem whose solution is reused, or the DoF itself
+    StandardVector<size_t, DOFs> equal_dofs;
+    StandardVector<bool, DOFs> is_mirrored_dof;
+
+    //! Synchronization groups of the input and the currently synchronized group, all DoFs are synchronized together without groups
+    const Vector<size_t>* synchronization_groups {nullptr};
+    size_t synchronization_group {0};
+
+    bool is_in_synchronization_group(size_t dof) const {
+        return !synchronization_groups || synchronization_groups->operator[](dof) == synchronization_group;
+    }
+
+    //! Set the synchronization of the input for the DoFs of the current group, and no synchronization for all other DoFs
+    void set_synchronization(const InputParameter<DOFs, CustomVector>& inp) {
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            const Synchronization synchronization = inp.per_dof_synchronization ? inp.per_dof_synchronization.value()[dof] : inp.synchronization;
+            limit_set.synchronization[dof] = is_in_synchronization_group(dof) ? synchronization : Synchronization::None;
+        }
+    }
+
+    //! Has the DoF the same problem as the other DoF, or the negated problem with swapped and negated limits if mirrored?
+    bool is_equal_dof(const InputParameter<DOFs, CustomVector>& inp, size_t dof, size_t other, bool mirrored) const {
+        const double sign = mirrored ? -1.0 : 1.0;
+        return inp.current_position[dof] == sign * inp.current_position[other]
+            && inp.current_velocity[dof] == sign * inp.current_velocity[other]
+            && inp.current_acceleration[dof] == sign * inp.current_acceleration[other]
+            && inp.target_position[dof] == sign * inp.target_position[other]
+            && inp.target_velocity[dof] == sign * inp.target_velocity[other]
+            && inp.target_acceleration[dof] == sign * inp.target_acceleration[other]
+            && limit_set.max_velocity[dof] == (mirrored ? -limit_set.min_velocity[other] : limit_set.max_velocity[other])
+            && limit_set.min_velocity[dof] == (mirrored ? -limit_set.max_velocity[other] : limit_set.min_velocity[other])
+            && limit_set.max_acceleration[dof] == (mirrored ? -limit_set.min_acceleration[other] : limit_set.max_acceleration[other])
+            && limit_set.min_acceleration[dof] == (mirrored ? -limit_set.max_acceleration[other] : limit_set.min_acceleration[other])
+            && limit_set.max_jerk[dof] == limit_set.max_jerk[other];
+    }
+
+    //! Find DoFs with the same (or mirrored) problem as a previous DoF, e.g. tandem axes or mirrored gripper fingers
+    void find_equal_dofs(const InputParameter<DOFs, CustomVector>& inp) {
+        for (size_t i = 0; i < number_of_active_dofs; ++i) {
+            const size_t dof = active_dofs[i];
+            equal_dofs[dof] = dof;
+            is_mirrored_dof[dof] = false;
+            if (!deduplicate_dofs) {
+                continue;
+            }
+
+            for (size_t j = 0; j < i; ++j) {
+                const size_t other = active_dofs[j];
+                if (
+                    equal_dofs[other] != other
+                    || limit_set.control_interface[dof] != limit_set.control_interface[other]
+                    || limit_set.synchronization[dof] != limit_set.synchronization[other]
+                    || (inp.per_dof_synchronization_group && inp.per_dof_synchronization_group.value()[dof] != inp.per_dof_synchronization_group.value()[other])
+                ) {
+                    continue;
+                }
+
+                if (is_equal_dof(inp, dof, other, false)) {
+                    equal_dofs[dof] = other;
+                    break;
+                }
+                if (is_equal_dof(inp, dof, other, true)) {
+                    equal_dofs[dof] = other;
+                    is_mirrored_dof[dof] = true;
+                    break;
+                }
+            }
+        }
+    }
 
     //! Is the trajectory (in principle) phase synchronizable?
     bool is_input_collinear(const InputParameter<DOFs, CustomVector>& inp, Profile::Direction limiting_direction, size_t limiting_dof) {
         // Check that vectors pd, v0, a0, vf, af are collinear
-        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+        for (size_t i = 0; i < number_of_active_dofs; ++i) {
+            const size_t dof = active_dofs[i];
             pd[dof] = inp.target_position[dof] - inp.current_position[dof];
         }
 
         const Vector<double>* scale_vector = nullptr;
         std::optional<size_t> scale_dof; // Need to find a scale DOF because limiting DOF might not be phase synchronized
-        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-            if (inp_per_dof_synchronization[dof] != Synchronization::Phase) {
+        for (size_t i = 0; i < number_of_active_dofs; ++i) {
+            const size_t dof = active_dofs[i];
+            if (limit_set.synchronization[dof] != Synchronization::Phase) {
                 continue;
             }
 
-            if (inp_per_dof_control_interface[dof] == ControlInterface::Position && std::abs(pd[dof]) > eps) {
+            if (limit_set.control_interface[dof] == ControlInterface::Position && std::abs(pd[dof]) > eps) {
                 scale_vector = &pd;
                 scale_dof = dof;
                 break;
@@ -93,19 +210,20 @@ private:
         const double af_scale = inp.target_acceleration[*scale_dof] / scale;
 
         const double scale_limiting = scale_vector->operator[](limiting_dof);
-        double control_limiting = (limiting_direction == Profile::Direction::UP) ? inp.max_jerk[limiting_dof] : -inp.max_jerk[limiting_dof];
-        if (std::isinf(inp.max_jerk[limiting_dof])) {
-            control_limiting = (limiting_direction == Profile::Direction::UP) ? inp.max_acceleration[limiting_dof] : inp_min_acceleration[limiting_dof];
+        double control_limiting = (limiting_direction == Profile::Direction::UP) ? limit_set.max_jerk[limiting_dof] : -limit_set.max_jerk[limiting_dof];
+        if (std::isinf(limit_set.max_jerk[limiting_dof])) {
+            control_limiting = (limiting_direction == Profile::Direction::UP) ? limit_set.max_acceleration[limiting_dof] : limit_set.min_acceleration[limiting_dof];
         }
 
-        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-            if (inp_per_dof_synchronization[dof] != Synchronization::Phase) {
+        for (size_t i = 0; i < number_of_active_dofs; ++i) {
+            const size_t dof = active_dofs[i];
+            if (limit_set.synchronization[dof] != Synchronization::Phase) {
                 continue;
             }
 
             const double current_scale = scale_vector->operator[](dof);
             if (
-                (inp_per_dof_control_interface[dof] == ControlInterface::Position && std::abs(pd[dof] - pd_scale * current_scale) > eps)
+                (limit_set.control_interface[dof] == ControlInterface::Position && std::abs(pd[dof] - pd_scale * current_scale) > eps)
                 || std::abs(inp.current_velocity[dof] - v0_scale * current_scale) > eps
                 || std::abs(inp.current_acceleration[dof] - a0_scale * current_scale) > eps
                 || std::abs(inp.target_velocity[dof] - vf_scale * current_scale) > eps
@@ -123,27 +241,33 @@ private:
     bool synchronize(std::optional<double> t_min, double& t_sync, std::optional<size_t>& limiting_dof, Vector<Profile>& profiles, bool discrete_duration, double delta_time) {
         // Check for (degrees_of_freedom == 1 && !t_min && !discrete_duration) is now outside
 
-        // Possible t_syncs are the start times of the intervals and optional t_min
+        // Possible t_syncs are the start times of the intervals and optional t_min, indexed by the active DoFs only
+        const size_t n = number_of_active_dofs;
         bool any_interval {false};
-        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-            // Ignore DoFs without synchronization here
-            if (inp_per_dof_synchronization[dof] == Synchronization::None) {
-                possible_t_syncs[dof] = 0.0;
-                possible_t_syncs[degrees_of_freedom + dof] = std::numeric_limits<double>::infinity();
-                possible_t_syncs[2 * degrees_of_freedom + dof] = std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < n; ++i) {
+            const size_t dof = active_dofs[i];
+
+            // Ignore DoFs without synchronization here, as well as equal DoFs whose candidates are given by the first DoF
+            if (limit_set.synchronization[dof] == Synchronization::None || equal_dofs[dof] != dof) {
+                possible_t_syncs[i] = 0.0;
+                possible_t_syncs[n + i] = std::numeric_limits<double>::infinity();
+                possible_t_syncs[2 * n + i] = std::numeric_limits<double>::infinity();
                 continue;
             }
 
-            possible_t_syncs[dof] = blocks[dof].t_min;
-            possible_t_syncs[degrees_of_freedom + dof] = blocks[dof].a ? blocks[dof].a->right : std::numeric_limits<double>::infinity();
-            possible_t_syncs[2 * degrees_of_freedom + dof] = blocks[dof].b ? blocks[dof].b->right : std::numeric_limits<double>::infinity();
+            possible_t_syncs[i] = blocks[dof].t_min;
+            possible_t_syncs[n + i] = blocks[dof].a ? blocks[dof].a->right : std::numeric_limits<double>::infinity();
+            possible_t_syncs[2 * n + i] = blocks[dof].b ? blocks[dof].b->right : std::numeric_limits<double>::infinity();
             any_interval |= blocks[dof].a || blocks[dof].b;
         }
-        possible_t_syncs[3 * degrees_of_freedom] = t_min.value_or(std::numeric_limits<double>::infinity());
-        any_interval |= t_min.has_value();
+
+        // Without any active DoF, the (optional) minimum duration is the only candidate
+        possible_t_syncs[3 * n] = t_min.value_or((n == 0) ? 0.0 : std::numeric_limits<double>::infinity());
+        any_interval |= t_min.has_value() || (n == 0);
 
         if (discrete_duration) {
-            for (auto& possible_t_sync: possible_t_syncs) {
+            for (size_t i = 0; i < 3 * n + 1; ++i) {
+                double& possible_t_sync = possible_t_syncs[i];
                 if (std::isinf(possible_t_sync)) {
                     continue;
                 }
@@ -156,16 +280,17 @@ private:
         }
 
         // Test them in sorted order
-        auto idx_end = any_interval ? idx.end() : idx.begin() + degrees_of_freedom;
+        auto idx_end = any_interval ? idx.begin() + 3 * n + 1 : idx.begin() + n;
         std::iota(idx.begin(), idx_end, 0);
         std::sort(idx.begin(), idx_end, [&](size_t i, size_t j) { return possible_t_syncs[i] < possible_t_syncs[j]; });
 
         // Start at last tmin (or worse)
-        for (auto i = idx.begin() + degrees_of_freedom - 1; i != idx_end; ++i) {
+        for (auto i = idx.begin() + std::max<size_t>(n, 1) - 1; i != idx_end; ++i) {
             const double possible_t_sync = possible_t_syncs[*i];
             bool is_blocked {false};
-            for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-                if (inp_per_dof_synchronization[dof] == Synchronization::None) {
+            for (size_t j = 0; j < n; ++j) {
+                const size_t dof = active_dofs[j];
+                if (limit_set.synchronization[dof] == Synchronization::None) {
                     continue; // inner dof loop
                 }
                 if (blocks[dof].is_blocked(possible_t_sync)) {
@@ -178,13 +303,13 @@ private:
             }
 
             t_sync = possible_t_sync;
-            if (*i == 3*degrees_of_freedom) { // Optional t_min
+            if (*i == 3 * n) { // Optional t_min
                 limiting_dof = std::nullopt;
                 return true;
             }
 
-            const auto div = std::div(static_cast<long>(*i), static_cast<long>(degrees_of_freedom));
-            limiting_dof = div.rem;
+            const auto div = std::div(static_cast<long>(*i), static_cast<long>(n));
+            limiting_dof = active_dofs[div.rem];
             switch (div.quot) {
                 case 0: {
                     profiles[limiting_dof.value()] = blocks[limiting_dof.value()].p_min;
@@ -202,146 +327,70 @@ private:
         return false;
     }
 
-public:
-    size_t degrees_of_freedom;
+    //! Calculate the derivatives of a duration of the DoF, if the maximum limits also define the unset minimum limits, their derivatives are included
+    bool calculate_sensitivity(const InputParameter<DOFs, CustomVector>& inp, size_t dof, const Profile& profile, DurationSensitivity& sensitivity) const {
+        if (limit_set.control_interface[dof] != ControlInterface::Position) {
+            sensitivity.set_unavailable();
+            return false;
+        }
 
-    template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
-    explicit TargetCalculator(): degrees_of_freedom(DOFs) { }
+        if (!sensitivity.calculate(profile, limit_set.max_velocity[dof], limit_set.min_velocity[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof], limit_set.max_jerk[dof])) {
+            return false;
+        }
 
-    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
-    explicit TargetCalculator(size_t dofs): degrees_of_freedom(dofs) {
-        blocks.resize(dofs);
-        inp_min_velocity.resize(dofs);
-        inp_min_acceleration.resize(dofs);
-        inp_per_dof_control_interface.resize(dofs);
-        inp_per_dof_synchronization.resize(dofs);
-        new_phase_control.resize(dofs);
-        pd.resize(dofs);
-        possible_t_syncs.resize(3*dofs+1);
-        idx.resize(3*dofs+1);
+        if (!inp.min_velocity) {
+            sensitivity.max_velocity -= sensitivity.min_velocity;
+        }
+        if (!inp.min_acceleration) {
+            sensitivity.max_acceleration -= sensitivity.min_acceleration;
+        }
+        return true;
     }
 
-    //! Calculate the time-optimal waypoint-based trajectory
-    template<bool throw_error>
-    Result calculate(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, double delta_time, bool& was_interrupted) {
-        was_interrupted = false;
-#if defined WITH_CLOUD_CLIENT
-        traj.resize(0);
-#endif
-
+    //! Calculate the derivatives of the independent minimum durations and of the synchronized duration
+    void calculate_sensitivities(const InputParameter<DOFs, CustomVector>& inp, const Trajectory<DOFs, CustomVector>& traj, std::optional<size_t> limiting_dof, bool discrete_duration) {
         for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-            auto& p = traj.profiles[0][dof];
-
-            inp_min_velocity[dof] = inp.min_velocity ? inp.min_velocity.value()[dof] : -inp.max_velocity[dof];
-            inp_min_acceleration[dof] = inp.min_acceleration ? inp.min_acceleration.value()[dof] : -inp.max_acceleration[dof];
-            inp_per_dof_control_interface[dof] = inp.per_dof_control_interface ? inp.per_dof_control_interface.value()[dof] : inp.control_interface;
-            inp_per_dof_synchronization[dof] = inp.per_dof_synchronization ? inp.per_dof_synchronization.value()[dof] : inp.synchronization;
-
-            if (!inp.enabled[dof]) {
-                p.p.back() = inp.current_position[dof];
-                p.v.back() = inp.current_velocity[dof];
-                p.a.back() = inp.current_acceleration[dof];
-                p.t_sum.back() = 0.0;
-                blocks[dof].t_min = 0.0;
-                blocks[dof].a = std::nullopt;
-                blocks[dof].b = std::nullopt;
+            if (!is_in_synchronization_group(dof)) {
                 continue;
             }
 
-            // Calculate brake (if input exceeds or will exceed limits)
-            switch (inp_per_dof_control_interface[dof]) {
-                case ControlInterface::Position: {
-                    if (!std::isinf(inp.max_jerk[dof])) {
-                        p.brake.get_position_brake_trajectory(inp.current_velocity[dof], inp.current_acceleration[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
-                        // p.accel.get_position_brake_trajectory(inp.target_velocity[dof], inp.target_acceleration[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
-                    } else if (!std::isinf(inp.max_acceleration[dof])) {
-                        p.brake.get_second_order_position_brake_trajectory(inp.current_velocity[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof]);
-                        // p.accel.get_second_order_position_brake_trajectory(inp.target_velocity[dof], inp.target_acceleration[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof]);
-                    }
-                    p.set_boundary(inp.current_position[dof], inp.current_velocity[dof], inp.current_acceleration[dof], inp.target_position[dof], inp.target_velocity[dof], inp.target_acceleration[dof]);
-                } break;
-                case ControlInterface::Velocity: {
-                    if (!std::isinf(inp.max_jerk[dof])) {
-                        p.brake.get_velocity_brake_trajectory(inp.current_acceleration[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
-                        // p.accel.get_velocity_brake_trajectory(inp.target_acceleration[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
-                    } else {
-                        p.brake.get_second_order_velocity_brake_trajectory();
-                        // p.accel.get_second_order_velocity_brake_trajectory();
-                    }
-                    p.set_boundary_for_velocity(inp.current_position[dof], inp.current_velocity[dof], inp.current_acceleration[dof], inp.target_velocity[dof], inp.target_acceleration[dof]);
-                } break;
-            }
-
-            // Finalize pre & post-trajectories
-            if (!std::isinf(inp.max_jerk[dof])) {
-                p.brake.finalize(p.p[0], p.v[0], p.a[0]);
-                // p.accel.finalize(p.pf, p.vf, p.af);
-            } else if (!std::isinf(inp.max_acceleration[dof])) {
-                p.brake.finalize_second_order(p.p[0], p.v[0], p.a[0]);
-                // p.accel.finalize_second_order(p.pf, p.vf, p.af);
-            }
-
-            bool found_profile {false};
-            switch (inp_per_dof_control_interface[dof]) {
-                case ControlInterface::Position: {
-                    if (!std::isinf(inp.max_jerk[dof])) {
-                        PositionThirdOrderStep1 step1 {p.p[0], p.v[0], p.a[0], p.pf, p.vf, p.af, inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]};
-                        found_profile = step1.get_profile(p, blocks[dof]);
-                    } else if (!std::isinf(inp.max_acceleration[dof])) {
-                        PositionSecondOrderStep1 step1 {p.p[0], p.v[0], p.pf, p.vf, inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof]};
-                        found_profile = step1.get_profile(p, blocks[dof]);
-                    } else {
-                        PositionFirstOrderStep1 step1 {p.p[0], p.pf, inp.max_velocity[dof], inp_min_velocity[dof]};
-                        found_profile = step1.get_profile(p, blocks[dof]);
-                    }
-                } break;
-                case ControlInterface::Velocity: {
-                    if (!std::isinf(inp.max_jerk[dof])) {
-                        VelocityThirdOrderStep1 step1 {p.v[0], p.a[0], p.vf, p.af, inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]};
-                        found_profile = step1.get_profile(p, blocks[dof]);
-                    } else {
-                        VelocitySecondOrderStep1 step1 {p.v[0], p.vf, inp.max_acceleration[dof], inp_min_acceleration[dof]};
-                        found_profile = step1.get_profile(p, blocks[dof]);
-                    }
-                } break;
+            duration_sensitivities[dof] = DurationSensitivity();
+            if (!inp.enabled[dof]) {
+                independent_min_duration_sensitivities[dof] = DurationSensitivity();
+                continue;
             }
 
-            if (!found_profile) {
-                const bool has_zero_limits = (inp.max_acceleration[dof] == 0.0 || inp_min_acceleration[dof] == 0.0 || inp.max_jerk[dof] == 0.0);
-                if (has_zero_limits) {
-                    if constexpr (throw_error) {
-                        throw RuckigError("zero limits conflict in step 1, dof: " + std::to_string(dof) + " input: " + inp.to_string());
-                    } else {
-                        return Result::ErrorZeroLimits;
-                    }
-
-                } else {
-                    if constexpr (throw_error) {
-                        throw RuckigError("error in step 1, dof: " + std::to_string(dof) + " input: " + inp.to_string());
-                    } else {
-                        return Result::ErrorExecutionTimeCalculation;
-                    }
-                }
-            }
+            calculate_sensitivity(inp, dof, blocks[dof].p_min, independent_min_duration_sensitivities[dof]);
+        }
 
-            traj.independent_min_durations[dof] = blocks[dof].t_min;
-            // std::cout << dof << " profile step1: " << blocks[dof].to_string() << std::endl;
+        // Otherwise, the duration is given by the minimum duration or the discretization and is locally constant
+        if (limiting_dof && !discrete_duration) {
+            calculate_sensitivity(inp, limiting_dof.value(), traj.profiles[0][limiting_dof.value()], duration_sensitivities[limiting_dof.value()]);
         }
+    }
 
+    //! Synchronize the DoFs (of the current group) and calculate their profiles for the synchronized duration
+    template<bool throw_error>
+    Result calculate_synchronized_step2(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, std::optional<double> t_min, double delta_time, bool duration_only) {
         const bool discrete_duration = (inp.duration_discretization == DurationDiscretization::Discrete);
-        if (degrees_of_freedom == 1 && !inp.minimum_duration && !discrete_duration) {
-            traj.duration = blocks[0].t_min;
-            traj.profiles[0][0] = blocks[0].p_min;
+        if (number_of_active_dofs == 1 && !synchronization_groups && !t_min && !discrete_duration) {
+            const size_t dof = active_dofs[0];
+            traj.duration = blocks[dof].t_min;
+            traj.profiles[0][dof] = blocks[dof].p_min;
             traj.cumulative_times[0] = traj.duration;
+            if (calculate_duration_sensitivities) {
+                calculate_sensitivities(inp, traj, dof, discrete_duration);
+            }
             return Result::Working;
         }
 
         std::optional<size_t> limiting_dof; // The DoF that doesn't need step 2
-        const bool found_synchronization = synchronize(inp.minimum_duration, traj.duration, limiting_dof, traj.profiles[0], discrete_duration, delta_time);
+        const bool found_synchronization = synchronize(t_min, traj.duration, limiting_dof, traj.profiles[0], discrete_duration, delta_time);
         if (!found_synchronization) {
             bool has_zero_limits = false;
-            for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-                if (inp.max_acceleration[dof] == 0.0 || inp_min_acceleration[dof] == 0.0 || inp.max_jerk[dof] == 0.0) {
+            for (size_t i = 0; i < number_of_active_dofs; ++i) {
+                const size_t dof = active_dofs[i];
+                if (limit_set.max_acceleration[dof] == 0.0 || limit_set.min_acceleration[dof] == 0.0 || limit_set.max_jerk[dof] == 0.0) {
                     has_zero_limits = true;
                     break;
                 }
@@ -364,8 +413,9 @@ public:
         }
 
         // None Synchronization
-        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-            if (inp.enabled[dof] && inp_per_dof_synchronization[dof] == Synchronization::None) {
+        for (size_t i = 0; i < number_of_active_dofs; ++i) {
+            const size_t dof = active_dofs[i];
+            if (limit_set.synchronization[dof] == Synchronization::None && is_in_synchronization_group(dof)) {
                 traj.profiles[0][dof] = blocks[dof].p_min;
                 if (blocks[dof].t_min > traj.duration) {
                     traj.duration = blocks[dof].t_min;
@@ -375,58 +425,78 @@ public:
         }
         traj.cumulative_times[0] = traj.duration;
 
+        if (calculate_duration_sensitivities) {
+            calculate_sensitivities(inp, traj, limiting_dof, discrete_duration);
+        }
+
         if constexpr (return_error_at_maximal_duration) {
             if (traj.duration > 7.6e3) {
                 return Result::ErrorTrajectoryDuration;
             }
         }
 
+        if (duration_only) {
+            return Result::Working;
+        }
+
         if (traj.duration == 0.0) {
             // Copy all profiles for end state
-            for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-                traj.profiles[0][dof] = blocks[dof].p_min;
+            for (size_t i = 0; i < number_of_active_dofs; ++i) {
+                const size_t dof = active_dofs[i];
+                if (is_in_synchronization_group(dof)) {
+                    traj.profiles[0][dof] = blocks[dof].p_min;
+                }
             }
             return Result::Working;
         }
 
-        if (!discrete_duration && std::all_of(inp_per_dof_synchronization.begin(), inp_per_dof_synchronization.end(), [](Synchronization s){ return s == Synchronization::None; })) {
+        if (!discrete_duration && std::all_of(limit_set.synchronization.begin(), limit_set.synchronization.end(), [](Synchronization s){ return s == Synchronization::None; })) {
             return Result::Working;
         }
 
         // Phase Synchronization
-        if (limiting_dof && std::any_of(inp_per_dof_synchronization.begin(), inp_per_dof_synchronization.end(), [](Synchronization s){ return s == Synchronization::Phase; })) {
+        if (limiting_dof && std::any_of(limit_set.synchronization.begin(), limit_set.synchronization.end(), [](Synchronization s){ return s == Synchronization::Phase; })) {
             const Profile& p_limiting = traj.profiles[0][limiting_dof.value()];
             if (is_input_collinear(inp, p_limiting.direction, limiting_dof.value())) {
                 bool found_time_synchronization {true};
-                for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-                    if (!inp.enabled[dof] || dof == limiting_dof || inp_per_dof_synchronization[dof] != Synchronization::Phase) {
+                for (size_t i = 0; i < number_of_active_dofs; ++i) {
+                    const size_t dof = active_dofs[i];
+                    if (dof == limiting_dof || limit_set.synchronization[dof] != Synchronization::Phase) {
                         continue;
                     }
 
                     Profile& p = traj.profiles[0][dof];
+                    if (equal_dofs[dof] != dof) {
+                        p = traj.profiles[0][equal_dofs[dof]];
+                        if (is_mirrored_dof[dof]) {
+                            p.mirror();
+                        }
+                        continue;
+                    }
+
                     const double t_profile = traj.duration - p.brake.duration - p.accel.duration;
 
                     p.t = p_limiting.t; // Copy timing information from limiting DoF
                     p.control_signs = p_limiting.control_signs;
 
                     // Profile::ReachedLimits::NONE is a small hack, as there is no specialization for that in the check function
-                    switch (inp_per_dof_control_interface[dof]) {
+                    switch (limit_set.control_interface[dof]) {
                         case ControlInterface::Position: {
                             switch (p.control_signs) {
                                 case Profile::ControlSigns::UDDU: {
-                                    if (!std::isinf(inp.max_jerk[dof])) {
-                                        found_time_synchronization &= p.check_with_timing<Profile::ControlSigns::UDDU, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
-                                    } else if (!std::isinf(inp.max_acceleration[dof])) {
-                                        found_time_synchronization &= p.check_for_second_order_with_timing<Profile::ControlSigns::UDDU, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], -new_phase_control[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof]);
+                                    if (!std::isinf(limit_set.max_jerk[dof])) {
+                                        found_time_synchronization &= p.check_with_timing<Profile::ControlSigns::UDDU, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], limit_set.max_velocity[dof], limit_set.min_velocity[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof], limit_set.max_jerk[dof]);
+                                    } else if (!std::isinf(limit_set.max_acceleration[dof])) {
+                                        found_time_synchronization &= p.check_for_second_order_with_timing<Profile::ControlSigns::UDDU, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], -new_phase_control[dof], limit_set.max_velocity[dof], limit_set.min_velocity[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof]);
                                     } else {
-                                        found_time_synchronization &= p.check_for_first_order_with_timing<Profile::ControlSigns::UDDU, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], inp.max_velocity[dof], inp_min_velocity[dof]);
+                                        found_time_synchronization &= p.check_for_first_order_with_timing<Profile::ControlSigns::UDDU, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], limit_set.max_velocity[dof], limit_set.min_velocity[dof]);
                                     }
                                 } break;
                                 case Profile::ControlSigns::UDUD: {
-                                    if (!std::isinf(inp.max_jerk[dof])) {
-                                        found_time_synchronization &= p.check_with_timing<Profile::ControlSigns::UDUD, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
+                                    if (!std::isinf(limit_set.max_jerk[dof])) {
+                                        found_time_synchronization &= p.check_with_timing<Profile::ControlSigns::UDUD, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], limit_set.max_velocity[dof], limit_set.min_velocity[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof], limit_set.max_jerk[dof]);
                                     } else {
-                                        found_time_synchronization &= p.check_for_second_order_with_timing<Profile::ControlSigns::UDUD, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], -new_phase_control[dof], inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof]);
+                                        found_time_synchronization &= p.check_for_second_order_with_timing<Profile::ControlSigns::UDUD, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], -new_phase_control[dof], limit_set.max_velocity[dof], limit_set.min_velocity[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof]);
                                     }
                                 } break;
                             }
@@ -434,17 +504,17 @@ public:
                         case ControlInterface::Velocity: {
                             switch (p.control_signs) {
                                 case Profile::ControlSigns::UDDU: {
-                                    if (!std::isinf(inp.max_jerk[dof])) {
-                                        found_time_synchronization &= p.check_for_velocity_with_timing<Profile::ControlSigns::UDDU, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
+                                    if (!std::isinf(limit_set.max_jerk[dof])) {
+                                        found_time_synchronization &= p.check_for_velocity_with_timing<Profile::ControlSigns::UDDU, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof], limit_set.max_jerk[dof]);
                                     } else {
-                                        found_time_synchronization &= p.check_for_second_order_velocity_with_timing<Profile::ControlSigns::UDDU, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], inp.max_acceleration[dof], inp_min_acceleration[dof]);
+                                        found_time_synchronization &= p.check_for_second_order_velocity_with_timing<Profile::ControlSigns::UDDU, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof]);
                                     }
                                 } break;
                                 case Profile::ControlSigns::UDUD: {
-                                    if (!std::isinf(inp.max_jerk[dof])) {
-                                        found_time_synchronization &= p.check_for_velocity_with_timing<Profile::ControlSigns::UDUD, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]);
+                                    if (!std::isinf(limit_set.max_jerk[dof])) {
+                                        found_time_synchronization &= p.check_for_velocity_with_timing<Profile::ControlSigns::UDUD, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof], limit_set.max_jerk[dof]);
                                     } else {
-                                        found_time_synchronization &= p.check_for_second_order_velocity_with_timing<Profile::ControlSigns::UDUD, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], inp.max_acceleration[dof], inp_min_acceleration[dof]);
+                                        found_time_synchronization &= p.check_for_second_order_velocity_with_timing<Profile::ControlSigns::UDUD, Profile::ReachedLimits::NONE>(t_profile, new_phase_control[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof]);
                                     }
                                 } break;
                             }
@@ -454,23 +524,34 @@ public:
                     p.limits = p_limiting.limits; // After check method call to set correct limits
                 }
 
-                if (found_time_synchronization && std::all_of(inp_per_dof_synchronization.begin(), inp_per_dof_synchronization.end(), [](Synchronization s){ return s == Synchronization::Phase || s == Synchronization::None; })) {
+                if (found_time_synchronization && std::all_of(limit_set.synchronization.begin(), limit_set.synchronization.end(), [](Synchronization s){ return s == Synchronization::Phase || s == Synchronization::None; })) {
                     return Result::Working;
                 }
             }
         }
 
         // Time Synchronization
-        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-            const bool skip_synchronization = (dof == limiting_dof || inp_per_dof_synchronization[dof] == Synchronization::None) && !discrete_duration;
-            if (!inp.enabled[dof] || skip_synchronization) {
+        for (size_t i = 0; i < number_of_active_dofs; ++i) {
+            const size_t dof = active_dofs[i];
+            const bool skip_synchronization = (dof == limiting_dof || limit_set.synchronization[dof] == Synchronization::None) && !discrete_duration;
+            if (skip_synchronization || !is_in_synchronization_group(dof)) {
                 continue;
             }
 
             Profile& p = traj.profiles[0][dof];
+
+            // The equal DoF was synchronized before (or is the limiting DoF)
+            if (equal_dofs[dof] != dof) {
+                p = traj.profiles[0][equal_dofs[dof]];
+                if (is_mirrored_dof[dof]) {
+                    p.mirror();
+                }
+                continue;
+            }
+
             const double t_profile = traj.duration - p.brake.duration - p.accel.duration;
 
-            if (inp_per_dof_synchronization[dof] == Synchronization::TimeIfNecessary && std::abs(inp.target_velocity[dof]) < eps && std::abs(inp.target_acceleration[dof]) < eps) {
+            if (limit_set.synchronization[dof] == Synchronization::TimeIfNecessary && std::abs(inp.target_velocity[dof]) < eps && std::abs(inp.target_acceleration[dof]) < eps) {
                 p = blocks[dof].p_min;
                 continue;
             }
@@ -489,25 +570,26 @@ public:
             }
 
             bool found_time_synchronization {false};
-            switch (inp_per_dof_control_interface[dof]) {
+            switch (limit_set.control_interface[dof]) {
                 case ControlInterface::Position: {
-                    if (!std::isinf(inp.max_jerk[dof])) {
-                        PositionThirdOrderStep2 step2 {t_profile, p.p[0], p.v[0], p.a[0], p.pf, p.vf, p.af, inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]};
+                    if (!std::isinf(limit_set.max_jerk[dof])) {
+                        PositionThirdOrderStep2 step2 {t_profile, p.p[0], p.v[0], p.a[0], p.pf, p.vf, p.af, limit_set.max_velocity[dof], limit_set.min_velocity[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof], limit_set.max_jerk[dof]};
+                        step2.family_statistics = adaptive_family_order ? &family_statistics : nullptr;
                         found_time_synchronization = step2.get_profile(p);
-                    } else if (!std::isinf(inp.max_acceleration[dof])) {
-                        PositionSecondOrderStep2 step2 {t_profile, p.p[0], p.v[0], p.pf, p.vf, inp.max_velocity[dof], inp_min_velocity[dof], inp.max_acceleration[dof], inp_min_acceleration[dof]};
+                    } else if (!std::isinf(limit_set.max_acceleration[dof])) {
+                        PositionSecondOrderStep2 step2 {t_profile, p.p[0], p.v[0], p.pf, p.vf, limit_set.max_velocity[dof], limit_set.min_velocity[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof]};
                         found_time_synchronization = step2.get_profile(p);
                     } else {
-                        PositionFirstOrderStep2 step2 {t_profile, p.p[0], p.pf, inp.max_velocity[dof], inp_min_velocity[dof]};
+                        PositionFirstOrderStep2 step2 {t_profile, p.p[0], p.pf, limit_set.max_velocity[dof], limit_set.min_velocity[dof]};
                         found_time_synchronization = step2.get_profile(p);
                     }
                 } break;
                 case ControlInterface::Velocity: {
-                    if (!std::isinf(inp.max_jerk[dof])) {
-                        VelocityThirdOrderStep2 step2 {t_profile, p.v[0], p.a[0], p.vf, p.af, inp.max_acceleration[dof], inp_min_acceleration[dof], inp.max_jerk[dof]};
+                    if (!std::isinf(limit_set.max_jerk[dof])) {
+                        VelocityThirdOrderStep2 step2 {t_profile, p.v[0], p.a[0], p.vf, p.af, limit_set.max_acceleration[dof], limit_set.min_acceleration[dof], limit_set.max_jerk[dof]};
                         found_time_synchronization = step2.get_profile(p);
                     } else {
-                        VelocitySecondOrderStep2 step2 {t_profile, p.v[0], p.vf, inp.max_acceleration[dof], inp_min_acceleration[dof]};
+                        VelocitySecondOrderStep2 step2 {t_profile, p.v[0], p.vf, limit_set.max_acceleration[dof], limit_set.min_acceleration[dof]};
                         found_time_synchronization = step2.get_profile(p);
                     }
                 } break;
@@ -525,6 +607,591 @@ public:
         return Result::Working;
     }
 
+    //! Scale the kinematic limits of a DoF like a time scaling: the velocity limits by the factor, acceleration by its square, and jerk by its cube
+    static void scale_limits(const InputParameter<DOFs, CustomVector>& inp, size_t dof, double scale, InputParameter<DOFs, CustomVector>& scaled_inp) {
+        scaled_inp.max_velocity[dof] = scale * inp.max_velocity[dof];
+        scaled_inp.max_acceleration[dof] = scale * scale * inp.max_acceleration[dof];
+        scaled_inp.max_jerk[dof] = scale * scale * scale * inp.max_jerk[dof];
+        if (inp.min_velocity) {
+            scaled_inp.min_velocity.value()[dof] = scale * inp.min_velocity.value()[dof];
+        }
+        if (inp.min_acceleration) {
+            scaled_inp.min_acceleration.value()[dof] = scale * scale * inp.min_acceleration.value()[dof];
+        }
+    }
+
+    static void scale_limits(const InputParameter<DOFs, CustomVector>& inp, double scale, InputParameter<DOFs, CustomVector>& scaled_inp) {
+        for (size_t dof = 0; dof < inp.degrees_of_freedom; ++dof) {
+            scale_limits(inp, dof, scale, scaled_inp);
+        }
+    }
+
+    //! Calculate the brake pre-trajectory of a single enabled DoF
+    void calculate_brake(const InputParameter<DOFs, CustomVector>& inp, size_t dof, Profile& p) const {
+        // Calculate brake (if input exceeds or will exceed limits)
+        switch (limit_set.control_interface[dof]) {
+            case ControlInterface::Position: {
+                if (!std::isinf(limit_set.max_jerk[dof])) {
+                    p.brake.get_position_brake_trajectory(inp.current_velocity[dof], inp.current_acceleration[dof], limit_set.max_velocity[dof], limit_set.min_velocity[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof], limit_set.max_jerk[dof]);
+                    // p.accel.get_position_brake_trajectory(inp.target_velocity[dof], inp.target_acceleration[dof], limit_set.max_velocity[dof], limit_set.min_velocity[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof], limit_set.max_jerk[dof]);
+                } else if (!std::isinf(limit_set.max_acceleration[dof])) {
+                    p.brake.get_second_order_position_brake_trajectory(inp.current_velocity[dof], limit_set.max_velocity[dof], limit_set.min_velocity[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof]);
+                    // p.accel.get_second_order_position_brake_trajectory(inp.target_velocity[dof], inp.target_acceleration[dof], limit_set.max_velocity[dof], limit_set.min_velocity[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof]);
+                }
+                p.set_boundary(inp.current_position[dof], inp.current_velocity[dof], inp.current_acceleration[dof], inp.target_position[dof], inp.target_velocity[dof], inp.target_acceleration[dof]);
+            } break;
+            case ControlInterface::Velocity: {
+                if (!std::isinf(limit_set.max_jerk[dof])) {
+                    p.brake.get_velocity_brake_trajectory(inp.current_acceleration[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof], limit_set.max_jerk[dof]);
+                    // p.accel.get_velocity_brake_trajectory(inp.target_acceleration[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof], limit_set.max_jerk[dof]);
+                } else {
+                    p.brake.get_second_order_velocity_brake_trajectory();
+                    // p.accel.get_second_order_velocity_brake_trajectory();
+                }
+                p.set_boundary_for_velocity(inp.current_position[dof], inp.current_velocity[dof], inp.current_acceleration[dof], inp.target_velocity[dof], inp.target_acceleration[dof]);
+            } break;
+        }
+
+        // Finalize pre & post-trajectories
+        if (!std::isinf(limit_set.max_jerk[dof])) {
+            p.brake.finalize(p.p[0], p.v[0], p.a[0]);
+            // p.accel.finalize(p.pf, p.vf, p.af);
+        } else if (!std::isinf(limit_set.max_acceleration[dof])) {
+            p.brake.finalize_second_order(p.p[0], p.v[0], p.a[0]);
+            // p.accel.finalize_second_order(p.pf, p.vf, p.af);
+        }
+    }
+
+    //! Calculate the minimal duration and blocked intervals of a single enabled DoF, given its brake pre-trajectory
+    bool calculate_block(const InputParameter<DOFs, CustomVector>& inp, size_t dof, Profile& p, Block& block) {
+        bool found_profile {false};
+        switch (limit_set.control_interface[dof]) {
+            case ControlInterface::Position: {
+                if (!std::isinf(limit_set.max_jerk[dof])) {
+                    // The brake is determined by the raw input, so key on that to reuse the block including its brake
+                    const BlockCache::Key key {inp.current_position[dof], inp.current_velocity[dof], inp.current_acceleration[dof], inp.target_position[dof], inp.target_velocity[dof], inp.target_acceleration[dof], limit_set.max_velocity[dof], limit_set.min_velocity[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof], limit_set.max_jerk[dof]};
+                    if (const Block* cached_block = step1_cache.find(key)) {
+                        block = *cached_block;
+                        found_profile = true;
+                        break;
+                    }
+
+                    PositionThirdOrderStep1 step1 {p.p[0], p.v[0], p.a[0], p.pf, p.vf, p.af, limit_set.max_velocity[dof], limit_set.min_velocity[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof], limit_set.max_jerk[dof]};
+                    step1.family_statistics = adaptive_family_order ? &family_statistics : nullptr;
+                    found_profile = normalize_step1 ? step1.get_normalized_profile(p, block, normalized_step1_cache) : step1.get_profile(p, block);
+                    if (found_profile) {
+                        step1_cache.insert(key, block);
+                    }
+                } else if (!std::isinf(limit_set.max_acceleration[dof])) {
+                    PositionSecondOrderStep1 step1 {p.p[0], p.v[0], p.pf, p.vf, limit_set.max_velocity[dof], limit_set.min_velocity[dof], limit_set.max_acceleration[dof], limit_set.min_acceleration[dof]};
+                    found_profile = step1.get_profile(p, block);
+                } else {
+                    PositionFirstOrderStep1 step1 {p.p[0], p.pf, limit_set.max_velocity[dof], limit_set.min_velocity[dof]};
+                    found_profile = step1.get_profile(p, block);
+                }
+            } break;
+            case ControlInterface::Velocity: {
+                if (!std::isinf(limit_set.max_jerk[dof])) {
+                    VelocityThirdOrderStep1 step1 {p.v[0], p.a[0], p.vf, p.af, limit_set.max_acceleration[dof], limit_set.min_acceleration[dof], limit_set.max_jerk[dof]};
+                    found_profile = step1.get_profile(p, block);
+                } else {
+                    VelocitySecondOrderStep1 step1 {p.v[0], p.vf, limit_set.max_acceleration[dof], limit_set.min_acceleration[dof]};
+                    found_profile = step1.get_profile(p, block);
+                }
+            } break;
+        }
+        return found_profile;
+    }
+
+public:
+    size_t degrees_of_freedom;
+
+    //! Optional cache of Step 1 results for the third-order position interface, disabled by default (zero capacity)
+    BlockCache step1_cache;
+
+    //! Solve Step 1 of the third-order position interface normalized to unit acceleration and jerk limits
+    bool normalize_step1 {false};
+
+    //! Optional cache of normalized Step 1 results, can be shared between DoFs and calculators with different limits
+    BlockCache* normalized_step1_cache {nullptr};
+
+    //! Calculate the derivatives of the durations with respect to the target state and the limits (third-order position interface only)
+    bool calculate_duration_sensitivities {false};
+
+    //! Derivatives of the independent minimum durations and of the synchronized duration of the last calculation, kept here so that trajectories stay small
+    StandardVector<DurationSensitivity, DOFs> independent_min_duration_sensitivities, duration_sensitivities;
+
+    //! Solve DoFs with an identical or mirrored (negated) problem only once and copy the solution (opt-in, as finding them costs time for unequal DoFs)
+    bool deduplicate_dofs {false};
+
+    //! Resolved limits and settings of the last input
+    LimitSet<DOFs> limit_set;
+
+    //! Try the profile families of the third-order position interface in the order of their past successes. The duration stays the
+    //! same, but if several profiles reach the target at this duration, the order decides which one is returned (in about 0.1% of the
+    //! random test inputs), so that the trajectory may differ from the one with the default order.
+    bool adaptive_family_order {false};
+
+    //! Success counts of the profile families, recorded only with the adaptive family order
+    FamilyStatistics family_statistics;
+
+    template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
+    explicit TargetCalculator(): degrees_of_freedom(DOFs) { }
+
+    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
+    explicit TargetCalculator(size_t dofs): degrees_of_freedom(dofs) {
+        blocks.resize(dofs);
+        limit_set.resize(dofs);
+        independent_min_duration_sensitivities.resize(dofs);
+        duration_sensitivities.resize(dofs);
+        active_dofs.resize(dofs);
+        equal_dofs.resize(dofs);
+        is_mirrored_dof.resize(dofs);
+        new_phase_control.resize(dofs);
+        pd.resize(dofs);
+        possible_t_syncs.resize(3*dofs+1);
+        idx.resize(3*dofs+1);
+    }
+
+    //! Set the per-DoF settings and the enabled DoFs, and calculate the brake pre-trajectories, which depend on the current state and the limits only
+    void calculate_brakes(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj) {
+        limit_set.update(inp);
+        blocks_input_hash = std::nullopt;
+
+        number_of_active_dofs = 0;
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            auto& p = traj.profiles[0][dof];
+
+            if (!inp.enabled[dof]) {
+                p.p.back() = inp.current_position[dof];
+                p.v.back() = inp.current_velocity[dof];
+                p.a.back() = inp.current_acceleration[dof];
+                p.t_sum.back() = 0.0;
+
+                blocks[dof].t_min = 0.0;
+                blocks[dof].a = std::nullopt;
+                blocks[dof].b = std::nullopt;
+                continue;
+            }
+
+            active_dofs[number_of_active_dofs] = dof;
+            number_of_active_dofs += 1;
+
+            calculate_brake(inp, dof, p);
+        }
+    }
+
+    //! Get the minimal duration and blocked intervals of each DoF from the last Step 1 calculation
+    const StandardVector<Block, DOFs>& get_blocks() const {
+        return blocks;
+    }
+
+    //! Calculate the minimal duration and blocked intervals of each DoF independently (Step 1)
+    template<bool throw_error>
+    Result calculate_step1(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj) {
+        find_equal_dofs(inp);
+
+        for (size_t i = 0; i < number_of_active_dofs; ++i) {
+            const size_t dof = active_dofs[i];
+            auto& p = traj.profiles[0][dof];
+
+            if (equal_dofs[dof] != dof) {
+                blocks[dof] = blocks[equal_dofs[dof]];
+                if (is_mirrored_dof[dof]) {
+                    blocks[dof].mirror();
+                }
+                traj.independent_min_durations[dof] = blocks[dof].t_min;
+                continue;
+            }
+
+            if (!calculate_block(inp, dof, p, blocks[dof])) {
+                const bool has_zero_limits = (limit_set.max_acceleration[dof] == 0.0 || limit_set.min_acceleration[dof] == 0.0 || limit_set.max_jerk[dof] == 0.0);
+                if (has_zero_limits) {
+                    if constexpr (throw_error) {
+                        throw RuckigError("zero limits conflict in step 1, dof: " + std::to_string(dof) + " input: " + inp.to_string());
+                    } else {
+                        return Result::ErrorZeroLimits;
+                    }
+
+                } else {
+                    if constexpr (throw_error) {
+                        throw RuckigError("error in step 1, dof: " + std::to_string(dof) + " input: " + inp.to_string());
+                    } else {
+                        return Result::ErrorExecutionTimeCalculation;
+                    }
+                }
+            }
+
+            traj.independent_min_durations[dof] = blocks[dof].t_min;
+            // std::cout << dof << " profile step1: " << blocks[dof].to_string() << std::endl;
+        }
+
+        blocks_input_hash = hash_input(inp);
+        return Result::Working;
+    }
+
+    //! Synchronize the DoFs and calculate their profiles for the synchronized duration (Step 2). Optionally, calculate the duration only.
+    template<bool throw_error>
+    Result calculate_step2(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, double delta_time, bool duration_only = false) {
+        return calculate_step2<throw_error>(inp, traj, inp.minimum_duration, delta_time, duration_only);
+    }
+
+    //! Calculate Step 2 for a given duration, e.g. a common duration of multiple calculators found from their blocks (see get_blocks).
+    //! The duration needs to be valid for all synchronized DoFs: not shorter than their minimal duration and outside their blocked intervals.
+    //! The input needs to be the same as in the last calculation of Step 1, otherwise an error is returned.
+    template<bool throw_error>
+    Result calculate_step2_for_duration(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, double duration, double delta_time) {
+        if (!has_blocks_of(inp)) {
+            if constexpr (throw_error) {
+                throw RuckigError("calculate_step2 requires the input of the last calculation of Step 1.");
+            } else {
+                return Result::ErrorInvalidInput;
+            }
+        }
+
+        return calculate_step2<throw_error>(inp, traj, std::max(inp.minimum_duration.value_or(0.0), duration), delta_time, false);
+    }
+
+    //! Calculate Step 2 with the given minimum duration instead of the one of the input
+    template<bool throw_error>
+    Result calculate_step2(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, std::optional<double> t_min, double delta_time, bool duration_only) {
+        synchronization_groups = nullptr;
+        if (!inp.per_dof_synchronization_group) {
+            return calculate_synchronized_step2<throw_error>(inp, traj, t_min, delta_time, duration_only);
+        }
+
+        // Synchronize each group on its own, while the DoFs of all other groups are ignored like DoFs without synchronization.
+        // In a single pass, the first DoF of each group calculates its group duration, so a DoF with a group duration is skipped.
+        synchronization_groups = &inp.per_dof_synchronization_group.value();
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            traj.group_durations[dof] = -1.0;
+        }
+
+        double duration {0.0};
+        Result result {Result::Working};
+        try {
+            for (size_t dof = 0; dof < degrees_of_freedom && result == Result::Working; ++dof) {
+                if (traj.group_durations[dof] >= 0.0) {
+                    continue;
+                }
+
+                synchronization_group = synchronization_groups->operator[](dof);
+                set_synchronization(inp);
+                result = calculate_synchronized_step2<throw_error>(inp, traj, t_min, delta_time, duration_only);
+                for (size_t group_dof = dof; group_dof < degrees_of_freedom; ++group_dof) {
+                    if (is_in_synchronization_group(group_dof)) {
+                        traj.group_durations[group_dof] = traj.duration;
+                    }
+                }
+                duration = std::max(duration, traj.duration);
+            }
+        } catch (...) {
+            synchronization_groups = nullptr;
+            set_synchronization(inp);
+            throw;
+        }
+
+        // Restore the synchronization of the input for a following Step 2 (e.g. retime)
+        synchronization_groups = nullptr;
+        set_synchronization(inp);
+
+        traj.duration = duration;
+        traj.cumulative_times[0] = duration;
+        return result;
+    }
+
+    //! Re-time the trajectory of the last calculation with the same input to a new duration. Only Step 2 is calculated again using
+    //! the kept blocks of Step 1, with an error if the duration is shorter than the minimal duration or within a blocked interval.
+    //! Any other calculation of this calculator in between (e.g. a limit scale or a batch) replaces the blocks, so that the input
+    //! doesn't match the blocks anymore and an error is returned as well.
+    template<bool throw_error>
+    Result retime(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, double duration, double delta_time) {
+        if (!has_blocks_of(inp)) {
+            if constexpr (throw_error) {
+                throw RuckigError("retime requires the input of the last calculation.");
+            } else {
+                return Result::ErrorInvalidInput;
+            }
+        }
+
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            if (inp.enabled[dof] && limit_set.synchronization[dof] != Synchronization::None && blocks[dof].is_blocked(duration)) {
+                if constexpr (throw_error) {
+                    throw RuckigError("duration " + std::to_string(duration) + " is blocked in dof: " + std::to_string(dof));
+                } else {
+                    return Result::ErrorSynchronizationCalculation;
+                }
+            }
+        }
+
+        return calculate_step2<throw_error>(inp, traj, duration, delta_time, false);
+    }
+
+    //! Calculate the time-optimal waypoint-based trajectory
+    template<bool throw_error>
+    Result calculate(const InputParameter<DOFs, CustomVector>& inp, Trajectory<DOFs, CustomVector>& traj, double delta_time, bool& was_interrupted) {
+        was_interrupted = false;
+#if defined WITH_CLOUD_CLIENT
+        traj.resize(0);
+#endif
+
+        calculate_brakes(inp, traj);
+
+        const Result result = calculate_step1<throw_error>(inp, traj);
+        if (result != Result::Working) {
+            return result;
+        }
+
+        return calculate_step2<throw_error>(inp, traj, delta_time);
+    }
+
+    //! Calculate the trajectories (or only their durations) from the current state of the input to the target states in [begin, end).
+    //! The brake pre-trajectories depend on the current state only and are calculated once. The target state of the input is overwritten.
+    template<bool throw_error>
+    void calculate_targets(InputParameter<DOFs, CustomVector>& inp, const std::vector<KinematicState<DOFs, CustomVector>>& targets, size_t begin, size_t end, Trajectory<DOFs, CustomVector>& origin, std::vector<Trajectory<DOFs, CustomVector>>* trajectories, std::vector<double>& durations, std::vector<Result>& results, double delta_time) {
+#if defined WITH_CLOUD_CLIENT
+        origin.resize(0);
+#endif
+        calculate_brakes(inp, origin);
+
+        Trajectory<DOFs, CustomVector> scratch = origin;
+        for (size_t i = begin; i < end; ++i) {
+            const auto& target = targets[i];
+            durations[i] = std::numeric_limits<double>::infinity();
+
+            // Invalid targets are reported per target, also for the throwing variant
+            if (!inp.template validate_target_state<false>(target.position, target.velocity, target.acceleration, true)) {
+                results[i] = Result::ErrorInvalidInput;
+                continue;
+            }
+
+            // Some synchronization strategies need the target state of the input
+            inp.target_position = target.position;
+            inp.target_velocity = target.velocity;
+            inp.target_acceleration = target.acceleration;
+
+            auto& traj = trajectories ? (*trajectories)[i] : scratch;
+#if defined WITH_CLOUD_CLIENT
+            traj.resize(0);
+#endif
+            for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+                auto& p = traj.profiles[0][dof];
+                p = origin.profiles[0][dof];
+                if (!inp.enabled[dof]) {
+                    continue;
+                }
+
+                p.pf = target.position[dof];
+                p.vf = target.velocity[dof];
+                p.af = target.acceleration[dof];
+            }
+
+            results[i] = calculate_step1<throw_error>(inp, traj);
+            if (results[i] == Result::Working) {
+                results[i] = calculate_step2<throw_error>(inp, traj, delta_time, !trajectories);
+            }
+            if (results[i] == Result::Working) {
+                durations[i] = traj.duration;
+            }
+        }
+    }
+
+    //! Calculate the trajectories (or only their durations) from the current states in [begin, end) to the target state of the input.
+    //! The target state is validated once beforehand, and a single scratch trajectory is shared. The current state of the input is overwritten.
+    template<bool throw_error>
+    void calculate_current_states(InputParameter<DOFs, CustomVector>& inp, const std::vector<KinematicState<DOFs, CustomVector>>& current_states, size_t begin, size_t end, Trajectory<DOFs, CustomVector>& scratch, std::vector<Trajectory<DOFs, CustomVector>>* trajectories, std::vector<double>& durations, std::vector<Result>& results, double delta_time) {
+        for (size_t i = begin; i < end; ++i) {
+            const auto& current_state = current_states[i];
+            durations[i] = std::numeric_limits<double>::infinity();
+
+            // Invalid current states are reported per state, also for the throwing variant
+            if (!inp.template validate_current_state<false>(current_state.position, current_state.velocity, current_state.acceleration, false)) {
+                results[i] = Result::ErrorInvalidInput;
+                continue;
+            }
+
+            inp.current_position = current_state.position;
+            inp.current_velocity = current_state.velocity;
+            inp.current_acceleration = current_state.acceleration;
+
+            auto& traj = trajectories ? (*trajectories)[i] : scratch;
+#if defined WITH_CLOUD_CLIENT
+            traj.resize(0);
+#endif
+            calculate_brakes(inp, traj);
+
+            results[i] = calculate_step1<throw_error>(inp, traj);
+            if (results[i] == Result::Working) {
+                results[i] = calculate_step2<throw_error>(inp, traj, delta_time, !trajectories);
+            }
+            if (results[i] == Result::Working) {
+                durations[i] = traj.duration;
+            }
+        }
+    }
+
+    //! Smallest scale of the limits of a single enabled DoF, at least the given minimal scale, so that it reaches its target at the given
+    //! duration (outside of its blocked intervals if synchronized). The scale is 1 if this is not possible within the original limits.
+    double calculate_dof_limit_scale(const InputParameter<DOFs, CustomVector>& inp, size_t dof, double duration, double min_scale, InputParameter<DOFs, CustomVector>& scaled_inp, Profile& p) {
+        constexpr size_t max_iterations {64};
+        constexpr double scale_precision {1e-12};
+
+        Block block;
+        auto calculate_scaled_block = [&](double s) {
+            scale_limits(inp, dof, s, scaled_inp);
+            if (!scaled_inp.template validate<false>(false, true)) {
+                return false;
+            }
+
+            limit_set.update(scaled_inp);
+            calculate_brake(scaled_inp, dof, p);
+            return calculate_block(scaled_inp, dof, p, block);
+        };
+
+        // DoFs without synchronization only need to reach their target within the duration
+        const bool is_synchronized = (limit_set.synchronization[dof] != Synchronization::None);
+        auto is_reached = [&]() {
+            return is_synchronized ? !block.is_blocked(duration) : (block.t_min <= duration);
+        };
+
+        if (!calculate_scaled_block(1.0) || !is_reached()) {
+            return 1.0;
+        }
+        if (block.t_min == 0.0) {
+            return min_scale;
+        }
+
+        // From and to rest, the minimal duration and the blocked intervals scale exactly with the inverse factor
+        if (inp.current_velocity[dof] == 0.0 && inp.current_acceleration[dof] == 0.0 && inp.target_velocity[dof] == 0.0 && inp.target_acceleration[dof] == 0.0) {
+            double s = std::max(min_scale, block.t_min / duration);
+            for (size_t i = 0; i < 2 && is_synchronized; ++i) {
+                for (const auto* interval: {&block.a, &block.b}) {
+                    if (*interval && (*interval)->left < s * duration && s * duration < (*interval)->right) {
+                        s = (*interval)->right / duration;
+                    }
+                }
+            }
+            return std::min(s, 1.0);
+        }
+
+        // Otherwise, the boundary states don't scale with the limits. Keep a bracket with an infeasible lower and a feasible upper scale.
+        double lower {min_scale}, upper {1.0};
+        if (min_scale > 0.0 && calculate_scaled_block(min_scale)) {
+            if (is_reached()) {
+                return min_scale;
+            }
+        }
+
+        // Find the scale of the minimal duration by a safeguarded Newton iteration that recalculates Step 1 of this DoF only
+        if (min_scale == 0.0 || block.t_min > duration) {
+            double s = std::max(min_scale, block.t_min / duration);
+            for (size_t i = 0; i < max_iterations && upper - lower > scale_precision; ++i) {
+                const bool is_valid = calculate_scaled_block(s);
+                if (is_valid && block.t_min <= duration) {
+                    upper = s;
+                    if (duration - block.t_min < scale_precision * duration) {
+                        break;
+                    }
+                } else {
+                    lower = s;
+                }
+
+                double derivative = std::numeric_limits<double>::quiet_NaN();
+                DurationSensitivity sensitivity;
+                if (is_valid && calculate_sensitivity(scaled_inp, dof, block.p_min, sensitivity)) {
+                    derivative = sensitivity.max_velocity * inp.max_velocity[dof] + 2 * s * sensitivity.max_acceleration * inp.max_acceleration[dof] + 3 * s * s * sensitivity.max_jerk * inp.max_jerk[dof];
+                    if (inp.min_velocity) {
+                        derivative += sensitivity.min_velocity * inp.min_velocity.value()[dof];
+                    }
+                    if (inp.min_acceleration) {
+                        derivative += 2 * s * sensitivity.min_acceleration * inp.min_acceleration.value()[dof];
+                    }
+                }
+
+                double s_next = (derivative < 0.0) ? s - (block.t_min - duration) / derivative : lower;
+                if (!(lower < s_next && s_next < upper)) {
+                    s_next = (lower + upper) / 2;
+                }
+                s = s_next;
+            }
+
+            if (calculate_scaled_block(upper) && is_reached()) {
+                return upper;
+            }
+            lower = upper;
+            upper = 1.0;
+        }
+
+        // The duration lies within a blocked interval, so bisect up to the end of the interval
+        while (upper - lower > scale_precision) {
+            const double s = (lower + upper) / 2;
+            if (calculate_scaled_block(s) && is_reached()) {
+                upper = s;
+            } else {
+                lower = s;
+            }
+        }
+        return upper;
+    }
+
+    //! Calculate the trajectory with the smallest scale of the kinematic limits (see scale_limits) that reaches the target within the given
+    //! duration. The scale is solved for each DoF independently and combined by the maximum over all DoFs. As the duration might then lie
+    //! within a blocked interval of another DoF, the DoFs are solved again for scales of at least the current maximum until it doesn't
+    //! change anymore. For a DoF from and to rest, its scale follows in closed form from its minimal duration and blocked intervals. Otherwise,
+    //! the boundary states don't scale with the limits and there is no closed form. Then the scale is found by a safeguarded Newton
+    //! iteration (or a bisection for blocked intervals) that recalculates Step 1 of this DoF only. If the duration can't be reached within
+    //! the original limits, the scale is 1 and ErrorSynchronizationCalculation is returned together with the trajectory of the next
+    //! reachable duration. The result is the smallest scale if a larger scale keeps each DoF feasible, which holds unless a
+    //! blocked interval of a DoF moves over the duration with increasing scale.
+    template<bool throw_error>
+    Result calculate_limit_scale(const InputParameter<DOFs, CustomVector>& inp, double duration, Trajectory<DOFs, CustomVector>& traj, double delta_time, double& scale) {
+        InputParameter<DOFs, CustomVector> scaled_inp = inp;
+
+        calculate_brakes(inp, traj);
+        double max_scale {0.0};
+        for (size_t pass = 0; pass < 2 * number_of_active_dofs + 1; ++pass) {
+            bool has_changed {false};
+            for (size_t i = 0; i < number_of_active_dofs; ++i) {
+                const size_t dof = active_dofs[i];
+                const double dof_scale = calculate_dof_limit_scale(inp, dof, duration, max_scale, scaled_inp, traj.profiles[0][dof]);
+                scale_limits(inp, dof, 1.0, scaled_inp);
+                if (dof_scale > max_scale) {
+                    max_scale = dof_scale;
+                    has_changed = true;
+                }
+            }
+
+            if (!has_changed || max_scale >= 1.0) {
+                break;
+            }
+        }
+        scale = (0.0 < max_scale && max_scale < 1.0) ? max_scale : 1.0;
+
+        if (scale < 1.0) {
+            scale_limits(inp, scale, scaled_inp);
+        }
+        scaled_inp.minimum_duration = std::max(inp.minimum_duration.value_or(0.0), duration);
+
+        bool was_interrupted;
+        const Result result = calculate<throw_error>(scaled_inp, traj, delta_time, was_interrupted);
+        if (result != Result::Working || scale < 1.0) {
+            return result;
+        }
+
+        // Within the original limits, the duration might be shorter than the minimal duration or blocked for a DoF
+        for (size_t i = 0; i < number_of_active_dofs; ++i) {
+            const size_t dof = active_dofs[i];
+            const bool is_synchronized = (limit_set.synchronization[dof] != Synchronization::None);
+            if (is_synchronized ? blocks[dof].is_blocked(duration) : (blocks[dof].t_min > duration)) {
+                if constexpr (throw_error) {
+                    throw RuckigError("duration " + std::to_string(duration) + " can't be reached within the limits in dof: " + std::to_string(dof));
+                }
+                return Result::ErrorSynchronizationCalculation;
+            }
+        }
+        return result;
+    }
+
     //! Continue the trajectory calculation
     template<bool throw_error>
     Result continue_calculation(const InputParameter<DOFs, CustomVector>&, Trajectory<DOFs, CustomVector>&, double, bool&) {
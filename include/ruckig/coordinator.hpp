@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <ruckig/block.hpp>
+#include <ruckig/input_parameter.hpp>
+#include <ruckig/result.hpp>
+
+
+namespace ruckig {
+
+//! @brief Synchronizes trajectories of multiple Ruckig instances, e.g. of separate robots with different DoFs and vector types
+//!
+//! Each motion is a tuple of a Ruckig instance, its input, and its trajectory, e.g. created by std::tie(otg, input, trajectory).
+//! Step 1 is calculated once per instance, then the earliest duration that isn't blocked for any synchronized DoF is searched
+//! across all instances, and finally only Step 2 is calculated by each instance for this common duration.
+class Coordinator {
+    //! Is the DoF considered for the common duration?
+    template<class Input>
+    static bool is_synchronized(const Input& input, size_t dof) {
+        const Synchronization synchronization = input.per_dof_synchronization ? input.per_dof_synchronization.value()[dof] : input.synchronization;
+        return input.enabled[dof] && synchronization != Synchronization::None;
+    }
+
+    template<class Motion>
+    static void add_possible_durations(const Motion& motion, double& t_min, std::vector<double>& possible_durations) {
+        const auto& [otg, input, trajectory] = motion;
+        const auto& blocks = otg.get_blocks();
+
+        t_min = std::max(t_min, input.minimum_duration.value_or(0.0));
+        for (size_t dof = 0; dof < otg.degrees_of_freedom; ++dof) {
+            if (!is_synchronized(input, dof)) {
+                continue;
+            }
+
+            t_min = std::max(t_min, blocks[dof].t_min);
+            if (blocks[dof].a) {
+                possible_durations.push_back(blocks[dof].a->right);
+            }
+            if (blocks[dof].b) {
+                possible_durations.push_back(blocks[dof].b->right);
+            }
+        }
+    }
+
+    template<class Motion>
+    static bool is_blocked(const Motion& motion, double duration) {
+        const auto& [otg, input, trajectory] = motion;
+        const auto& blocks = otg.get_blocks();
+
+        for (size_t dof = 0; dof < otg.degrees_of_freedom; ++dof) {
+            if (is_synchronized(input, dof) && blocks[dof].is_blocked(duration)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    //! Earliest common duration of motions with calculated Step 1, or nullopt if there is none
+    template<class... Motions>
+    static std::optional<double> find_duration(const Motions&... motions) {
+        double t_min {0.0};
+        std::vector<double> possible_durations;
+        (add_possible_durations(motions, t_min, possible_durations), ...);
+
+        possible_durations.push_back(t_min);
+        std::sort(possible_durations.begin(), possible_durations.end());
+        for (const double duration: possible_durations) {
+            if (duration >= t_min && !(is_blocked(motions, duration) || ...)) {
+                return duration;
+            }
+        }
+        return std::nullopt;
+    }
+
+    //! Calculate the trajectories of all motions with their earliest common duration. Durations are continuous,
+    //! so instances with discrete durations might round up individually. Intermediate positions are ignored.
+    template<class... Motions>
+    static Result calculate(Motions&&... motions) {
+        Result result {Result::Working};
+        auto calculate_step1 = [&result](auto& motion) {
+            auto& [otg, input, trajectory] = motion;
+            if (result == Result::Working) {
+                result = otg.calculate_step1(input, trajectory);
+            }
+        };
+        (calculate_step1(motions), ...);
+        if (result != Result::Working) {
+            return result;
+        }
+
+        const std::optional<double> duration = find_duration(motions...);
+        if (!duration) {
+            return Result::ErrorSynchronizationCalculation;
+        }
+
+        auto calculate_step2 = [&result, &duration](auto& motion) {
+            auto& [otg, input, trajectory] = motion;
+            if (result == Result::Working) {
+                result = otg.calculate_step2(input, trajectory, duration.value());
+            }
+        };
+        (calculate_step2(motions), ...);
+        return result;
+    }
+};
+
+} // namespace ruckig
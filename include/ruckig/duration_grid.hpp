@@ -0,0 +1,319 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ruckig/calculator_target.hpp>
+#include <ruckig/error.hpp>
+#include <ruckig/input_parameter.hpp>
+#include <ruckig/result.hpp>
+#include <ruckig/trajectory.hpp>
+
+
+namespace ruckig {
+
+//! Single-DoF quantity of the input parameter that is varied along a grid axis
+enum class GridQuantity {
+    CurrentPosition, CurrentVelocity, CurrentAcceleration,
+    TargetPosition, TargetVelocity, TargetAcceleration,
+    MaxVelocity, MaxAcceleration, MaxJerk,
+};
+
+
+//! Equidistant axis of a duration grid with count samples in [min, max]
+struct GridAxis {
+    GridQuantity quantity;
+    size_t dof;
+    double min, max;
+    size_t count;
+
+    double at(size_t i) const {
+        return (count > 1) ? min + (max - min) * i / (count - 1) : min;
+    }
+};
+
+
+//! Minimal trajectory durations over an N-dimensional grid of input parameters, e.g. as a time-to-go table for scheduling
+template<size_t DOFs, template<class, size_t> class CustomVector = StandardVector>
+class DurationGrid {
+    constexpr static char file_identifier[8] {'R', 'U', 'C', 'K', 'D', 'G', 'R', 'D'};
+    constexpr static uint32_t file_version {2};
+
+    //! Written in native byte order, so that a file from a machine with another endianness is detected
+    constexpr static uint32_t file_byte_order {0x01020304};
+
+    //! Upper bound of the grid points of a loaded file, to reject corrupt sizes before allocating
+    constexpr static uint64_t max_file_points {uint64_t(1) << 32};
+
+    template<class T>
+    static bool read_value(std::ifstream& file, T& value) {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+
+    static void set_quantity(InputParameter<DOFs, CustomVector>& inp, const GridAxis& axis, double value) {
+        switch (axis.quantity) {
+            case GridQuantity::CurrentPosition: inp.current_position[axis.dof] = value; break;
+            case GridQuantity::CurrentVelocity: inp.current_velocity[axis.dof] = value; break;
+            case GridQuantity::CurrentAcceleration: inp.current_acceleration[axis.dof] = value; break;
+            case GridQuantity::TargetPosition: inp.target_position[axis.dof] = value; break;
+            case GridQuantity::TargetVelocity: inp.target_velocity[axis.dof] = value; break;
+            case GridQuantity::TargetAcceleration: inp.target_acceleration[axis.dof] = value; break;
+            case GridQuantity::MaxVelocity: inp.max_velocity[axis.dof] = value; break;
+            case GridQuantity::MaxAcceleration: inp.max_acceleration[axis.dof] = value; break;
+            case GridQuantity::MaxJerk: inp.max_jerk[axis.dof] = value; break;
+        }
+    }
+
+    //! Calculate the grid points in [begin, end) with their own calculator, input, and scratch trajectory
+    void calculate_range(const InputParameter<DOFs, CustomVector>& input, size_t begin, size_t end, double delta_time) {
+        InputParameter<DOFs, CustomVector> inp = input;
+        TargetCalculator<DOFs, CustomVector> calculator = new_calculator(input.degrees_of_freedom);
+        Trajectory<DOFs, CustomVector> traj = new_trajectory(input.degrees_of_freedom);
+
+        // Warm start from the neighboring grid point: the Step 1 blocks of DoFs whose quantities did not change are reused
+        calculator.step1_cache.resize(16 * input.degrees_of_freedom);
+
+        std::vector<size_t> index (axes.size());
+        for (size_t i = begin; i < end; ++i) {
+            // Successive points differ in the last axis only, so update the other quantities on carry only
+            size_t remainder = i;
+            for (size_t a = axes.size(); a-- > 0;) {
+                const size_t axis_index = remainder % axes[a].count;
+                remainder /= axes[a].count;
+                if (i == begin || axis_index != index[a]) {
+                    index[a] = axis_index;
+                    set_quantity(inp, axes[a], axes[a].at(axis_index));
+                }
+            }
+
+            durations[i] = std::numeric_limits<double>::infinity();
+            if (!inp.template validate<false>(false, true)) {
+                continue;
+            }
+
+            calculator.calculate_brakes(inp, traj);
+            if (calculator.template calculate_step1<false>(inp, traj) == Result::Working && calculator.template calculate_step2<false>(inp, traj, delta_time, true) == Result::Working) {
+                durations[i] = traj.get_duration();
+            }
+        }
+    }
+
+    static TargetCalculator<DOFs, CustomVector> new_calculator([[maybe_unused]] size_t dofs) {
+        if constexpr (DOFs >= 1) {
+            return TargetCalculator<DOFs, CustomVector>();
+        } else {
+            return TargetCalculator<DOFs, CustomVector>(dofs);
+        }
+    }
+
+    static Trajectory<DOFs, CustomVector> new_trajectory([[maybe_unused]] size_t dofs) {
+        if constexpr (DOFs >= 1) {
+            return Trajectory<DOFs, CustomVector>();
+        } else {
+            return Trajectory<DOFs, CustomVector>(dofs);
+        }
+    }
+
+public:
+    //! Maximal number of axes for the interpolation
+    constexpr static size_t max_axes {20};
+
+    //! Grid axes, the last axis is stored contiguously
+    std::vector<GridAxis> axes;
+
+    //! Minimal durations in row-major order, infinity for invalid or failed grid points
+    std::vector<double> durations;
+
+    explicit DurationGrid() { }
+
+    explicit DurationGrid(const std::vector<GridAxis>& axes): axes(axes) { }
+
+    size_t size() const {
+        size_t result {1};
+        for (const auto& axis: axes) {
+            result *= axis.count;
+        }
+        return result;
+    }
+
+    //! Calculate all grid points, starting from the given input. Only the minimal duration is calculated (Step 2 is skipped).
+    void calculate(const InputParameter<DOFs, CustomVector>& input, size_t number_of_threads = 1, double delta_time = 0.0) {
+        for (const auto& axis: axes) {
+            if (axis.dof >= input.degrees_of_freedom) {
+                throw RuckigError("grid axis of DoF " + std::to_string(axis.dof) + " exceeds the degrees of freedom of the input.");
+            }
+        }
+
+        const size_t number_of_points = size();
+        durations.resize(number_of_points);
+
+        number_of_threads = std::max<size_t>(std::min(number_of_threads, number_of_points), 1);
+        const size_t chunk_size = (number_of_points + number_of_threads - 1) / number_of_threads;
+
+        std::vector<std::exception_ptr> exceptions (number_of_threads);
+        auto calculate_chunk = [&](size_t begin, size_t end, std::exception_ptr& exception) {
+            try {
+                calculate_range(input, begin, end, delta_time);
+            } catch (...) {
+                exception = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(number_of_threads - 1);
+        for (size_t i = 1; i < number_of_threads; ++i) {
+            threads.emplace_back(calculate_chunk, std::min(i * chunk_size, number_of_points), std::min((i + 1) * chunk_size, number_of_points), std::ref(exceptions[i]));
+        }
+        calculate_chunk(0, std::min(chunk_size, number_of_points), exceptions[0]);
+
+        for (auto& thread: threads) {
+            thread.join();
+        }
+        for (const auto& exception: exceptions) {
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+    }
+
+    //! Multilinear interpolation of the duration over the corners of the axes whose value lies between two grid points, values outside the grid are clamped. Returns NaN if the durations don't match the axes. Does not allocate.
+    template<class Values>
+    double at(const Values& values) const {
+        if (axes.size() > max_axes || durations.size() != size()) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+
+        // Axes on a grid point contribute to the base index only, so that only the 2^k corners of the k interpolated axes are summed
+        std::array<size_t, max_axes> strides;
+        std::array<double, max_axes> fraction;
+        size_t number_of_interpolated_axes {0};
+        size_t base_index {0}, stride {1};
+        for (size_t a = axes.size(); a-- > 0;) {
+            const auto& axis = axes[a];
+            if (axis.count > 1 && axis.max != axis.min) {
+                const double position = std::clamp((values[a] - axis.min) / (axis.max - axis.min), 0.0, 1.0) * (axis.count - 1);
+                const size_t lower = std::min(static_cast<size_t>(position), axis.count - 1);
+                base_index += lower * stride;
+                if (position > lower) {
+                    strides[number_of_interpolated_axes] = stride;
+                    fraction[number_of_interpolated_axes] = position - lower;
+                    ++number_of_interpolated_axes;
+                }
+            }
+            stride *= axis.count;
+        }
+
+        double result {0.0};
+        for (size_t corner = 0; corner < (size_t(1) << number_of_interpolated_axes); ++corner) {
+            double weight {1.0};
+            size_t flat_index {base_index};
+            for (size_t i = 0; i < number_of_interpolated_axes; ++i) {
+                if ((corner >> i) & 1) {
+                    weight *= fraction[i];
+                    flat_index += strides[i];
+                } else {
+                    weight *= 1.0 - fraction[i];
+                }
+            }
+            result += weight * durations[flat_index];
+        }
+        return result;
+    }
+
+    //! Write the grid into a binary file. The durations are stored contiguously at the end, so that the file can be memory-mapped.
+    bool save(const std::string& filename) const {
+        std::ofstream file (filename, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+
+        const uint64_t number_of_axes = axes.size();
+        file.write(file_identifier, sizeof(file_identifier));
+        file.write(reinterpret_cast<const char*>(&file_version), sizeof(file_version));
+        file.write(reinterpret_cast<const char*>(&file_byte_order), sizeof(file_byte_order));
+        file.write(reinterpret_cast<const char*>(&number_of_axes), sizeof(number_of_axes));
+        for (const auto& axis: axes) {
+            const uint64_t quantity = static_cast<uint64_t>(axis.quantity), dof = axis.dof, count = axis.count;
+            file.write(reinterpret_cast<const char*>(&quantity), sizeof(quantity));
+            file.write(reinterpret_cast<const char*>(&dof), sizeof(dof));
+            file.write(reinterpret_cast<const char*>(&axis.min), sizeof(axis.min));
+            file.write(reinterpret_cast<const char*>(&axis.max), sizeof(axis.max));
+            file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        }
+        file.write(reinterpret_cast<const char*>(durations.data()), durations.size() * sizeof(double));
+        return static_cast<bool>(file);
+    }
+
+    //! Read a grid from a binary file written by save() on a machine with the same byte order
+    template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
+    bool load(const std::string& filename) {
+        return load(filename, DOFs);
+    }
+
+    //! Read a grid from a binary file, rejecting axes of DoFs beyond the given number of DoFs. Needs to be used for dynamic DoFs.
+    bool load(const std::string& filename, size_t degrees_of_freedom) {
+        std::ifstream file (filename, std::ios::binary);
+        char identifier[sizeof(file_identifier)];
+        if (!file.read(identifier, sizeof(identifier)) || !std::equal(identifier, identifier + sizeof(identifier), file_identifier)) {
+            return false;
+        }
+
+        uint32_t version, byte_order;
+        if (!read_value(file, version) || !read_value(file, byte_order) || version != file_version || byte_order != file_byte_order) {
+            return false;
+        }
+
+        uint64_t number_of_axes;
+        if (!read_value(file, number_of_axes) || number_of_axes > max_axes) {
+            return false;
+        }
+
+        std::vector<GridAxis> new_axes (number_of_axes);
+        uint64_t number_of_points {1};
+        for (auto& axis: new_axes) {
+            uint64_t quantity, dof, count;
+            if (!read_value(file, quantity) || !read_value(file, dof) || !read_value(file, axis.min) || !read_value(file, axis.max) || !read_value(file, count)) {
+                return false;
+            }
+            if (quantity > static_cast<uint64_t>(GridQuantity::MaxJerk) || dof >= degrees_of_freedom || count == 0 || count > max_file_points / number_of_points) {
+                return false;
+            }
+
+            axis.quantity = static_cast<GridQuantity>(quantity);
+            axis.dof = dof;
+            axis.count = count;
+            number_of_points *= count;
+        }
+
+        // The remaining file needs to be exactly the duration block
+        const auto durations_begin = file.tellg();
+        file.seekg(0, std::ios::end);
+        const auto file_end = file.tellg();
+        if (durations_begin < 0 || file_end < 0 || static_cast<uint64_t>(file_end - durations_begin) != number_of_points * sizeof(double)) {
+            return false;
+        }
+        file.seekg(durations_begin);
+
+        std::vector<double> new_durations (number_of_points);
+        if (!file.read(reinterpret_cast<char*>(new_durations.data()), new_durations.size() * sizeof(double))) {
+            return false;
+        }
+
+        axes = std::move(new_axes);
+        durations = std::move(new_durations);
+        return true;
+    }
+};
+
+} // namespace ruckig
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <utility>
+
+
+namespace ruckig {
+
+//! Success counts of the profile families of the third-order position interface, to try the most likely families first
+class FamilyStatistics {
+    template<size_t N>
+    static void record(std::array<size_t, N>& hits, std::array<size_t, N>& order, size_t family) {
+        hits[family] += 1;
+
+        size_t i {0};
+        while (order[i] != family) {
+            ++i;
+        }
+
+        // Move the family ahead of all families with fewer successes, ties keep their previous order
+        while (i > 0 && hits[order[i - 1]] < hits[family]) {
+            std::swap(order[i - 1], order[i]);
+            --i;
+        }
+    }
+
+public:
+    //! Number of families of Step 1 that can be reordered (only for a target state at rest, as all families are required otherwise)
+    constexpr static size_t step1_families {6};
+
+    //! Number of families of Step 2, each in both directions
+    constexpr static size_t step2_families {16};
+
+    //! Number of successes per family, indexed by the default order of attempts
+    std::array<size_t, step1_families> step1_hits;
+    std::array<size_t, step2_families> step2_hits;
+
+    //! Current order of attempts, sorted by decreasing number of successes
+    std::array<size_t, step1_families> step1_order;
+    std::array<size_t, step2_families> step2_order;
+
+    explicit FamilyStatistics() {
+        reset();
+    }
+
+    void reset() {
+        step1_hits.fill(0);
+        step2_hits.fill(0);
+        std::iota(step1_order.begin(), step1_order.end(), 0);
+        std::iota(step2_order.begin(), step2_order.end(), 0);
+    }
+
+    void record_step1(size_t family) {
+        record(step1_hits, step1_order, family);
+    }
+
+    void record_step2(size_t family) {
+        record(step2_hits, step2_order, family);
+    }
+};
+
+} // namespace ruckig
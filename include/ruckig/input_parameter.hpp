@@ -33,6 +33,39 @@ enum class DurationDiscretization {
 };
 
 
+//! Kinematic state of all DoFs, e.g. one of many target states calculated from the same current state
+template<size_t DOFs, template<class, size_t> class CustomVector = StandardVector>
+class KinematicState {
+    template<class T> using Vector = CustomVector<T, DOFs>;
+
+    void initialize() {
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            position[dof] = 0.0;
+            velocity[dof] = 0.0;
+            acceleration[dof] = 0.0;
+        }
+    }
+
+public:
+    size_t degrees_of_freedom;
+
+    Vector<double> position, velocity, acceleration;
+
+    template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
+    KinematicState(): degrees_of_freedom(DOFs) {
+        initialize();
+    }
+
+    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
+    KinematicState(size_t dofs): degrees_of_freedom(dofs) {
+        position.resize(dofs);
+        velocity.resize(dofs);
+        acceleration.resize(dofs);
+        initialize();
+    }
+};
+
+
 //! Input of the Ruckig algorithm
 template<size_t DOFs, template<class, size_t> class CustomVector = StandardVector>
 class InputParameter {
@@ -42,6 +75,151 @@ class InputParameter {
         return v0 + (a0 * a0) / (2 * j);
     }
 
+    inline bool is_position_interface(size_t dof) const {
+        return (per_dof_control_interface ? per_dof_control_interface.value()[dof] : control_interface) == ControlInterface::Position;
+    }
+
+    template<bool throw_validation_error>
+    bool validate_acceleration_limits(size_t dof) const {
+        const double jMax = max_jerk[dof];
+        if (std::isnan(jMax) || jMax < 0.0) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError("maximum jerk limit " + std::to_string(jMax) + " of DoF " + std::to_string(dof) + " should be larger than or equal to zero.");
+            }
+            return false;
+        }
+
+        const double aMax = max_acceleration[dof];
+        if (std::isnan(aMax) || aMax < 0.0) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError("maximum acceleration limit " + std::to_string(aMax) + " of DoF " + std::to_string(dof) + " should be larger than or equal to zero.");
+            }
+            return false;
+        }
+
+        const double aMin = min_acceleration ? min_acceleration.value()[dof] : -max_acceleration[dof];
+        if (std::isnan(aMin) || aMin > 0.0) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError("minimum acceleration limit " + std::to_string(aMin) + " of DoF " + std::to_string(dof) + " should be smaller than or equal to zero.");
+            }
+            return false;
+        }
+
+        return true;
+    }
+
+    template<bool throw_validation_error>
+    bool validate_velocity_limits(size_t dof) const {
+        const double vMax = max_velocity[dof];
+        if (std::isnan(vMax) || vMax < 0.0) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError("maximum velocity limit " + std::to_string(vMax) + " of DoF " + std::to_string(dof) + " should be larger than or equal to zero.");
+            }
+            return false;
+        }
+
+        const double vMin = min_velocity ? min_velocity.value()[dof] : -max_velocity[dof];
+        if (std::isnan(vMin) || vMin > 0.0) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError("minimum velocity limit " + std::to_string(vMin) + " of DoF " + std::to_string(dof) + " should be smaller than or equal to zero.");
+            }
+            return false;
+        }
+
+        return true;
+    }
+
+    template<bool throw_validation_error>
+    bool validate_limits(size_t dof) const {
+        return validate_acceleration_limits<throw_validation_error>(dof) && (!is_position_interface(dof) || validate_velocity_limits<throw_validation_error>(dof));
+    }
+
+    //! Validate the current or target state of a DoF, assuming that its limits are valid
+    template<bool throw_validation_error, bool is_target>
+    bool validate_state(size_t dof, double p, double v, double a, bool check_within_limits) const {
+        constexpr const char* name = is_target ? "target" : "current";
+
+        if (std::isnan(a)) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError(std::string(name) + " acceleration " + std::to_string(a) + " of DoF " + std::to_string(dof) + " should be a valid number.");
+            }
+            return false;
+        }
+
+        if (check_within_limits) {
+            const double aMax = max_acceleration[dof];
+            const double aMin = min_acceleration ? min_acceleration.value()[dof] : -max_acceleration[dof];
+            if (a > aMax) {
+                if constexpr (throw_validation_error) {
+                    throw RuckigError(std::string(name) + " acceleration " + std::to_string(a) + " of DoF " + std::to_string(dof) + " exceeds its maximum acceleration limit " + std::to_string(aMax) + ".");
+                }
+                return false;
+            }
+            if (a < aMin) {
+                if constexpr (throw_validation_error) {
+                    throw RuckigError(std::string(name) + " acceleration " + std::to_string(a) + " of DoF " + std::to_string(dof) + " undercuts its minimum acceleration limit " + std::to_string(aMin) + ".");
+                }
+                return false;
+            }
+        }
+
+        if (std::isnan(v)) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError(std::string(name) + " velocity " + std::to_string(v) + " of DoF " + std::to_string(dof) + " should be a valid number.");
+            }
+            return false;
+        }
+
+        // The position and velocity limits are only relevant for the position interface
+        if (!is_position_interface(dof)) {
+            return true;
+        }
+
+        if (std::isnan(p)) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError(std::string(name) + " position " + std::to_string(p) + " of DoF " + std::to_string(dof) + " should be a valid number.");
+            }
+            return false;
+        }
+
+        if (!check_within_limits) {
+            return true;
+        }
+
+        const double vMax = max_velocity[dof];
+        const double vMin = min_velocity ? min_velocity.value()[dof] : -max_velocity[dof];
+        if (v > vMax) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError(std::string(name) + " velocity " + std::to_string(v) + " of DoF " + std::to_string(dof) + " exceeds its maximum velocity limit " + std::to_string(vMax) + ".");
+            }
+            return false;
+        }
+        if (v < vMin) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError(std::string(name) + " velocity " + std::to_string(v) + " of DoF " + std::to_string(dof) + " undercuts its minimum velocity limit " + std::to_string(vMin) + ".");
+            }
+            return false;
+        }
+
+        // The velocity at zero acceleration is reached after the current state, or was passed before the target state
+        const double jMax = max_jerk[dof];
+        constexpr const char* reach = is_target ? " will inevitably have reached a velocity " : " will inevitably reach a velocity ";
+        if ((is_target ? a < 0 : a > 0) && jMax > 0 && v_at_a_zero(v, a, jMax) > vMax) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError("DoF " + std::to_string(dof) + reach + std::to_string(v_at_a_zero(v, a, jMax)) + " from the " + name + " kinematic state that will exceed its maximum velocity limit " + std::to_string(vMax) + ".");
+            }
+            return false;
+        }
+        if ((is_target ? a > 0 : a < 0) && jMax > 0 && v_at_a_zero(v, a, -jMax) < vMin) {
+            if constexpr (throw_validation_error) {
+                throw RuckigError("DoF " + std::to_string(dof) + reach + std::to_string(v_at_a_zero(v, a, -jMax)) + " from the " + name + " kinematic state that will undercut its minimum velocity limit " + std::to_string(vMin) + ".");
+            }
+            return false;
+        }
+
+        return true;
+    }
+
     void initialize() {
         for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
             current_velocity[dof] = 0.0;
@@ -54,6 +232,7 @@ class InputParameter {
         }
     }
 
+    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
     void resize(size_t dofs) {
         current_position.resize(dofs);
         current_velocity.resize(dofs);
@@ -110,6 +289,9 @@ public:
     //! Per-DoF synchronization (overwrites global synchronization)
     std::optional<Vector<Synchronization>> per_dof_synchronization;
 
+    //! Per-DoF synchronization group, DoFs are synchronized only within their group (each group has its own duration)
+    std::optional<Vector<size_t>> per_dof_synchronization_group;
+
     //! Optional minimum trajectory duration
     std::optional<double> minimum_duration;
 
@@ -150,34 +332,51 @@ public:
     }
 #endif
 
-    //! Validate the input for trajectory calculation
+    //! Validate the kinematic limits only, e.g. before calculating trajectories between many states
     template<bool throw_validation_error = true>
-    bool validate(bool check_current_state_within_limits = false, bool check_target_state_within_limits = true) const {
+    bool validate_limits() const {
         for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
-            const double jMax = max_jerk[dof];
-            if (std::isnan(jMax) || jMax < 0.0) {
-                if constexpr (throw_validation_error) {
-                    throw RuckigError("maximum jerk limit " + std::to_string(jMax) + " of DoF " + std::to_string(dof) + " should be larger than or equal to zero.");
-                }
+            if (!validate_limits<throw_validation_error>(dof)) {
                 return false;
             }
+        }
+        return true;
+    }
 
-            const double aMax = max_acceleration[dof];
-            if (std::isnan(aMax) || aMax < 0.0) {
-                if constexpr (throw_validation_error) {
-                    throw RuckigError("maximum acceleration limit " + std::to_string(aMax) + " of DoF " + std::to_string(dof) + " should be larger than or equal to zero.");
-                }
+    //! Validate a current state for the (already validated) kinematic limits
+    template<bool throw_validation_error = true>
+    bool validate_current_state(const Vector<double>& position, const Vector<double>& velocity, const Vector<double>& acceleration, bool check_current_state_within_limits = false) const {
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            if (!validate_state<throw_validation_error, false>(dof, position[dof], velocity[dof], acceleration[dof], check_current_state_within_limits)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //! Validate a target state for the (already validated) kinematic limits
+    template<bool throw_validation_error = true>
+    bool validate_target_state(const Vector<double>& position, const Vector<double>& velocity, const Vector<double>& acceleration, bool check_target_state_within_limits = true) const {
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            if (!validate_state<throw_validation_error, true>(dof, position[dof], velocity[dof], acceleration[dof], check_target_state_within_limits)) {
                 return false;
             }
+        }
+        return true;
+    }
 
-            const double aMin = min_acceleration ? min_acceleration.value()[dof] : -max_acceleration[dof];
-            if (std::isnan(aMin) || aMin > 0.0) {
-                if constexpr (throw_validation_error) {
-                    throw RuckigError("minimum acceleration limit " + std::to_string(aMin) + " of DoF " + std::to_string(dof) + " should be smaller than or equal to zero.");
-                }
+    //! Validate the input for trajectory calculation
+    template<bool throw_validation_error = true>
+    bool validate(bool check_current_state_within_limits = false, bool check_target_state_within_limits = true) const {
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            if (!validate_acceleration_limits<throw_validation_error>(dof)) {
                 return false;
             }
 
+            const double jMax = max_jerk[dof];
+            const double aMax = max_acceleration[dof];
+            const double aMin = min_acceleration ? min_acceleration.value()[dof] : -max_acceleration[dof];
+
             const double a0 = current_acceleration[dof];
             if (std::isnan(a0)) {
                 if constexpr (throw_validation_error) {
@@ -237,8 +436,8 @@ public:
                 return false;
             }
 
-            auto control_interface_ = per_dof_control_interface ? per_dof_control_interface.value()[dof] : control_interface;
-            if (control_interface_ == ControlInterface::Position) {
+            // Only the position interface uses the position and velocity limits, which are validated right before their use
+            if (is_position_interface(dof)) {
                 const double p0 = current_position[dof];
                 if (std::isnan(p0)) {
                     if constexpr (throw_validation_error) {
@@ -254,21 +453,12 @@ public:
                     return false;
                 }
 
-                const double vMax = max_velocity[dof];
-                if (std::isnan(vMax) || vMax < 0.0) {
-                    if constexpr (throw_validation_error) {
-                        throw RuckigError("maximum velocity limit " + std::to_string(vMax) + " of DoF " + std::to_string(dof) + " should be larger than or equal to zero.");
-                    }
+                if (!validate_velocity_limits<throw_validation_error>(dof)) {
                     return false;
                 }
 
+                const double vMax = max_velocity[dof];
                 const double vMin = min_velocity ? min_velocity.value()[dof] : -max_velocity[dof];
-                if (std::isnan(vMin) || vMin > 0.0) {
-                    if constexpr (throw_validation_error) {
-                        throw RuckigError("minimum velocity limit " + std::to_string(vMin) + " of DoF " + std::to_string(dof) + " should be smaller than or equal to zero.");
-                    }
-                    return false;
-                }
 
                 if (check_current_state_within_limits) {
                     if (v0 > vMax) {
@@ -364,10 +554,24 @@ public:
             current_position == rhs.current_position
             && current_velocity == rhs.current_velocity
             && current_acceleration == rhs.current_acceleration
-            && target_position == rhs.target_position
+            && is_equal_except_current_state(rhs)
+        );
+    }
+
+    //! Are all parameters except the current state equal?
+    bool is_equal_except_current_state(const InputParameter<DOFs, CustomVector>& rhs) const {
+        return (
+            target_position == rhs.target_position
             && target_velocity == rhs.target_velocity
             && target_acceleration == rhs.target_acceleration
-            && max_velocity == rhs.max_velocity
+            && is_equal_except_kinematic_state(rhs)
+        );
+    }
+
+    //! Are all parameters except the current and target state equal?
+    bool is_equal_except_kinematic_state(const InputParameter<DOFs, CustomVector>& rhs) const {
+        return (
+            max_velocity == rhs.max_velocity
             && max_acceleration == rhs.max_acceleration
             && max_jerk == rhs.max_jerk
             && intermediate_positions == rhs.intermediate_positions
@@ -390,6 +594,7 @@ public:
             && duration_discretization == rhs.duration_discretization
             && per_dof_control_interface == rhs.per_dof_control_interface
             && per_dof_synchronization == rhs.per_dof_synchronization
+            && per_dof_synchronization_group == rhs.per_dof_synchronization_group
         );
     }
 
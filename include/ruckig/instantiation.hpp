@@ -0,0 +1,34 @@
+#pragma once
+
+#include <ruckig/ruckig.hpp>
+
+
+namespace ruckig {
+
+//! Explicit instantiations of the main class templates for common DoFs with the standard vector type
+#define RUCKIG_INSTANTIATE_DOFS(EXTERN, DOFS) \
+    EXTERN template class InputParameter<DOFS>; \
+    EXTERN template class OutputParameter<DOFS>; \
+    EXTERN template class Trajectory<DOFS>; \
+    EXTERN template class TargetCalculator<DOFS>; \
+    EXTERN template class Calculator<DOFS>; \
+    EXTERN template class Ruckig<DOFS, StandardVector, false>; \
+    EXTERN template class Ruckig<DOFS, StandardVector, true>;
+
+#define RUCKIG_INSTANTIATE(EXTERN) \
+    RUCKIG_INSTANTIATE_DOFS(EXTERN, DynamicDOFs) \
+    RUCKIG_INSTANTIATE_DOFS(EXTERN, 1) \
+    RUCKIG_INSTANTIATE_DOFS(EXTERN, 2) \
+    RUCKIG_INSTANTIATE_DOFS(EXTERN, 3) \
+    RUCKIG_INSTANTIATE_DOFS(EXTERN, 4) \
+    RUCKIG_INSTANTIATE_DOFS(EXTERN, 5) \
+    RUCKIG_INSTANTIATE_DOFS(EXTERN, 6) \
+    RUCKIG_INSTANTIATE_DOFS(EXTERN, 7) \
+    RUCKIG_INSTANTIATE_DOFS(EXTERN, 8)
+
+// The library is built with the explicit instantiations, so that other translation units can skip them
+#if defined RUCKIG_EXPLICIT_INSTANTIATION
+RUCKIG_INSTANTIATE(extern)
+#endif
+
+} // namespace ruckig
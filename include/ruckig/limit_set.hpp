@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include <ruckig/input_parameter.hpp>
+#include <ruckig/utils.hpp>
+
+
+namespace ruckig {
+
+//! Per-DoF kinematic limits and settings of an input, resolved from the optional and global values
+template<size_t DOFs>
+class LimitSet {
+public:
+    //! Limits with the unset minimum limits resolved to the negative maximum limits
+    StandardVector<double, DOFs> max_velocity, min_velocity, max_acceleration, min_acceleration, max_jerk;
+
+    //! Resolved per-DoF control interface and synchronization
+    StandardVector<ControlInterface, DOFs> control_interface;
+    StandardVector<Synchronization, DOFs> synchronization;
+
+    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
+    void resize(size_t dofs) {
+        max_velocity.resize(dofs);
+        min_velocity.resize(dofs);
+        max_acceleration.resize(dofs);
+        min_acceleration.resize(dofs);
+        max_jerk.resize(dofs);
+        control_interface.resize(dofs);
+        synchronization.resize(dofs);
+    }
+
+    //! Resolve the limits and settings of the input
+    template<template<class, size_t> class CustomVector>
+    void update(const InputParameter<DOFs, CustomVector>& inp) {
+        for (size_t dof = 0; dof < inp.degrees_of_freedom; ++dof) {
+            control_interface[dof] = inp.per_dof_control_interface ? inp.per_dof_control_interface.value()[dof] : inp.control_interface;
+            synchronization[dof] = inp.per_dof_synchronization ? inp.per_dof_synchronization.value()[dof] : inp.synchronization;
+
+            max_velocity[dof] = inp.max_velocity[dof];
+            min_velocity[dof] = inp.min_velocity ? inp.min_velocity.value()[dof] : -inp.max_velocity[dof];
+            max_acceleration[dof] = inp.max_acceleration[dof];
+            min_acceleration[dof] = inp.min_acceleration ? inp.min_acceleration.value()[dof] : -inp.max_acceleration[dof];
+            max_jerk[dof] = inp.max_jerk[dof];
+        }
+    }
+};
+
+} // namespace ruckig
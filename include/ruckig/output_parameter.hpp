@@ -15,6 +15,7 @@ template<size_t DOFs, template<class, size_t> class CustomVector = StandardVecto
 class OutputParameter {
     template<class T> using Vector = CustomVector<T, DOFs>;
 
+    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
     void resize(size_t dofs) {
         new_position.resize(dofs);
         new_velocity.resize(dofs);
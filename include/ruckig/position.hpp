@@ -3,6 +3,9 @@
 #include <array>
 #include <optional>
 
+#include <ruckig/block_cache.hpp>
+#include <ruckig/family_statistics.hpp>
+
 
 namespace ruckig {
 
@@ -48,9 +51,15 @@ class PositionThirdOrderStep1 {
     }
 
 public:
+    //! Optional statistics to try the most successful families first and to record the successes
+    FamilyStatistics* family_statistics {nullptr};
+
     explicit PositionThirdOrderStep1(double p0, double v0, double a0, double pf, double vf, double af, double vMax, double vMin, double aMax, double aMin, double jMax);
 
     bool get_profile(const Profile& input, Block& block);
+
+    //! Solve the problem normalized to unit acceleration and jerk limits, optionally reusing normalized blocks from a (shared) cache
+    bool get_normalized_profile(const Profile& input, Block& block, BlockCache* cache = nullptr);
 };
 
 
@@ -84,9 +93,15 @@ class PositionThirdOrderStep2 {
     bool time_none(Profile& profile, double vMax, double vMin, double aMax, double aMin, double jMax);
     bool time_none_smooth(Profile& profile, double vMax, double vMin, double aMax, double aMin, double jMax);
 
+    //! Try a single family, indexed by the default order of attempts
+    bool time_family(size_t family, Profile& profile, double vMax, double vMin, double aMax, double aMin, double jMax);
+
 public:
     bool minimize_jerk {false};
 
+    //! Optional statistics to try the most successful families first and to record the successes
+    FamilyStatistics* family_statistics {nullptr};
+
     explicit PositionThirdOrderStep2(double tf, double p0, double v0, double a0, double pf, double vf, double af, double vMax, double vMin, double aMax, double aMin, double jMax);
 
     bool get_profile(Profile& profile);
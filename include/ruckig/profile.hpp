@@ -280,6 +280,24 @@ public:
         return (std::abs(jf) < std::abs(jMax) + j_eps) && check_with_timing<control_signs, limits>(tf, jf, vMax, vMin, aMax, aMin);
     }
 
+    //! Negate the kinematic state, so that the profile corresponds to the mirrored (negated) input with mirrored limits
+    void mirror() {
+        for (size_t i = 0; i < 7; ++i) {
+            j[i] = -j[i];
+        }
+        for (size_t i = 0; i < 8; ++i) {
+            a[i] = -a[i];
+            v[i] = -v[i];
+            p[i] = -p[i];
+        }
+        pf = -pf;
+        vf = -vf;
+        af = -af;
+        brake.mirror();
+        accel.mirror();
+        direction = (direction == Direction::UP) ? Direction::DOWN : Direction::UP;
+    }
+
     inline void set_boundary(const Profile& profile) {
         a[0] = profile.a[0];
         v[0] = profile.v[0];
@@ -528,4 +546,80 @@ public:
     }
 };
 
+
+//! Buffer for the candidate timings of a profile family, so that their phase durations are validated together before the full check
+template<size_t N>
+class ProfileCandidates {
+    using ReachedLimits = Profile::ReachedLimits;
+    using ControlSigns = Profile::ControlSigns;
+
+    //! Stored phase-major, so that the checks run over all candidates (lanes) of a phase at once
+    std::array<std::array<double, N>, 7> t;
+    std::array<ControlSigns, N> control_signs;
+    size_t size {0};
+
+public:
+    void add(ControlSigns signs, const std::array<double, 7>& t_candidate) {
+        for (size_t i = 0; i < 7; ++i) {
+            t[i][size] = t_candidate[i];
+        }
+        control_signs[size] = signs;
+        size += 1;
+    }
+
+    //! Check the candidates in the order they were added, the first valid one is written into the profile
+    template<ReachedLimits limits>
+    bool check_with_timing(Profile& profile, double tf, double jf, double vMax, double vMin, double aMax, double aMin) {
+        // Reject all candidates with negative (or too short limited) phases without branching per candidate
+        std::array<double, N> t_min;
+        for (size_t k = 0; k < size; ++k) {
+            t_min[k] = t[0][k];
+        }
+        for (size_t i = 1; i < 7; ++i) {
+            for (size_t k = 0; k < size; ++k) {
+                t_min[k] = std::min(t_min[k], t[i][k]);
+            }
+        }
+
+        std::array<bool, N> is_valid;
+        for (size_t k = 0; k < size; ++k) {
+            is_valid[k] = (t_min[k] >= 0);
+
+            if constexpr (limits == ReachedLimits::ACC0_ACC1_VEL || limits == ReachedLimits::ACC0_VEL || limits == ReachedLimits::ACC1_VEL || limits == ReachedLimits::VEL) {
+                is_valid[k] &= (t[3][k] >= std::numeric_limits<double>::epsilon());
+            }
+
+            if constexpr (limits == ReachedLimits::ACC0 || limits == ReachedLimits::ACC0_ACC1) {
+                is_valid[k] &= (t[1][k] >= std::numeric_limits<double>::epsilon());
+            }
+
+            if constexpr (limits == ReachedLimits::ACC1 || limits == ReachedLimits::ACC0_ACC1) {
+                is_valid[k] &= (t[5][k] >= std::numeric_limits<double>::epsilon());
+            }
+        }
+
+        for (size_t k = 0; k < size; ++k) {
+            if (!is_valid[k]) {
+                continue;
+            }
+
+            for (size_t i = 0; i < 7; ++i) {
+                profile.t[i] = t[i][k];
+            }
+
+            if (control_signs[k] == ControlSigns::UDDU) {
+                if (profile.check_with_timing<ControlSigns::UDDU, limits>(tf, jf, vMax, vMin, aMax, aMin)) {
+                    return true;
+                }
+            } else {
+                if (profile.check_with_timing<ControlSigns::UDUD, limits>(tf, jf, vMax, vMin, aMax, aMin)) {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+};
+
 } // namespace ruckig
@@ -3,12 +3,15 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <exception>
 #include <iostream>
 #include <limits>
 #include <math.h>
 #include <numeric>
 #include <optional>
+#include <thread>
 #include <tuple>
+#include <vector>
 
 #include <ruckig/calculator.hpp>
 #include <ruckig/error.hpp>
@@ -28,10 +31,128 @@ class Ruckig {
     //! Flag that indicates if the current_input was properly initialized
     bool current_input_initialized {false};
 
+    //! Input and trajectory precomputed for a predicted input, allocated once so that the handover doesn't allocate
+    InputParameter<DOFs, CustomVector> precomputed_input;
+    Trajectory<DOFs, CustomVector> precomputed_trajectory;
+    bool has_precomputed_input {false};
+
+    //! Is the kinematic state of the input within the tolerances of the reference, with all other parameters unchanged? Without
+    //! a tolerance, the corresponding values need to be equal. The target state is compared only if include_target_state is set,
+    //! otherwise it needs to be equal as well.
+    bool is_within_tolerance(const InputParameter<DOFs, CustomVector>& input, const InputParameter<DOFs, CustomVector>& reference, bool include_target_state) const {
+        const bool has_target_tolerance = include_target_state && (target_position_tolerance || target_velocity_tolerance || target_acceleration_tolerance);
+        if (!position_tolerance && !velocity_tolerance && !acceleration_tolerance && !has_target_tolerance) {
+            return false;
+        }
+
+        auto is_within = [](const std::optional<CustomVector<double, DOFs>>& tolerance, size_t dof, double value, double reference_value) {
+            return tolerance ? std::abs(value - reference_value) <= tolerance.value()[dof] : value == reference_value;
+        };
+
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            if (
+                !is_within(position_tolerance, dof, input.current_position[dof], reference.current_position[dof])
+                || !is_within(velocity_tolerance, dof, input.current_velocity[dof], reference.current_velocity[dof])
+                || !is_within(acceleration_tolerance, dof, input.current_acceleration[dof], reference.current_acceleration[dof])
+            ) {
+                return false;
+            }
+
+            if (include_target_state && (
+                !is_within(target_position_tolerance, dof, input.target_position[dof], reference.target_position[dof])
+                || !is_within(target_velocity_tolerance, dof, input.target_velocity[dof], reference.target_velocity[dof])
+                || !is_within(target_acceleration_tolerance, dof, input.target_acceleration[dof], reference.target_acceleration[dof])
+            )) {
+                return false;
+            }
+        }
+
+        return include_target_state ? input.is_equal_except_kinematic_state(reference) : input.is_equal_except_current_state(reference);
+    }
+
+    Trajectory<DOFs, CustomVector> new_trajectory() const {
+        if constexpr (DOFs >= 1) {
+            return Trajectory<DOFs, CustomVector>();
+        } else {
+            return Trajectory<DOFs, CustomVector>(degrees_of_freedom);
+        }
+    }
+
+    //! Calculate a batch of trajectories, in which either the target states (fan-out) or the current states (fan-in) vary
+    Result calculate_batch(const InputParameter<DOFs, CustomVector>& input, const std::vector<KinematicState<DOFs, CustomVector>>& states, bool vary_current_state, std::vector<Trajectory<DOFs, CustomVector>>* trajectories, std::vector<double>& durations, std::vector<Result>& results, size_t number_of_threads) {
+        // Validate the limits and the shared state only once
+        if (!input.template validate_limits<throw_error>()) {
+            return Result::ErrorInvalidInput;
+        }
+        if (vary_current_state && !input.template validate_target_state<throw_error>(input.target_position, input.target_velocity, input.target_acceleration, true)) {
+            return Result::ErrorInvalidInput;
+        }
+        if (!vary_current_state && !input.template validate_current_state<throw_error>(input.current_position, input.current_velocity, input.current_acceleration, false)) {
+            return Result::ErrorInvalidInput;
+        }
+
+        if (delta_time <= 0.0 && input.duration_discretization != DurationDiscretization::Continuous) {
+            if constexpr (throw_error) {
+                throw RuckigError("delta time (control rate) parameter " + std::to_string(delta_time) + " should be larger than zero.");
+            }
+            return Result::ErrorInvalidInput;
+        }
+
+        const size_t number_of_states = states.size();
+        durations.resize(number_of_states);
+        results.resize(number_of_states);
+        if (trajectories) {
+            trajectories->resize(number_of_states, new_trajectory());
+        }
+
+        number_of_threads = std::max<size_t>(std::min(number_of_threads, number_of_states), 1);
+        const size_t chunk_size = (number_of_states + number_of_threads - 1) / number_of_threads;
+
+        auto calculate_chunk = [&](TargetCalculator<DOFs, CustomVector>& target_calculator, size_t begin, size_t end, std::exception_ptr& exception) {
+            try {
+                InputParameter<DOFs, CustomVector> inp = input;
+                Trajectory<DOFs, CustomVector> trajectory = new_trajectory();
+                if (vary_current_state) {
+                    target_calculator.template calculate_current_states<throw_error>(inp, states, begin, end, trajectory, trajectories, durations, results, delta_time);
+                } else {
+                    target_calculator.template calculate_targets<throw_error>(inp, states, begin, end, trajectory, trajectories, durations, results, delta_time);
+                }
+            } catch (...) {
+                exception = std::current_exception();
+            }
+        };
+
+        // Every additional thread needs its own calculator. The shared normalized Step 1 cache is not thread-safe.
+        std::vector<TargetCalculator<DOFs, CustomVector>> target_calculators (number_of_threads - 1, calculator.target_calculator);
+        std::vector<std::exception_ptr> exceptions (number_of_threads);
+        std::vector<std::thread> threads;
+        threads.reserve(number_of_threads - 1);
+        for (size_t i = 1; i < number_of_threads; ++i) {
+            target_calculators[i - 1].normalized_step1_cache = nullptr;
+            threads.emplace_back(calculate_chunk, std::ref(target_calculators[i - 1]), std::min(i * chunk_size, number_of_states), std::min((i + 1) * chunk_size, number_of_states), std::ref(exceptions[i]));
+        }
+        calculate_chunk(calculator.target_calculator, 0, std::min(chunk_size, number_of_states), exceptions[0]);
+
+        for (auto& thread: threads) {
+            thread.join();
+        }
+        for (const auto& exception: exceptions) {
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+
+        const auto failed = std::find_if(results.begin(), results.end(), [](Result result) { return result != Result::Working; });
+        return (failed != results.end()) ? *failed : Result::Working;
+    }
+
 public:
     //! Calculator for new trajectories
     Calculator<DOFs, CustomVector> calculator;
 
+    //! Separate calculator for precompute, so that the state of the last calculation (e.g. its blocks for retime) is kept
+    Calculator<DOFs, CustomVector> precompute_calculator;
+
     //! Max number of intermediate waypoints
     const size_t max_number_of_waypoints;
 
@@ -41,6 +162,21 @@ public:
     //! Time step between updates (cycle time) in [s]
     double delta_time {0.0};
 
+    //! Optional per-DoF tolerances of the current state for update: if the current state of the input deviates from the state
+    //! predicted by the trajectory within these tolerances (and all other parameters are unchanged), the trajectory is kept
+    //! instead of calculating a new one. Without a tolerance, the corresponding kinematic value needs to be equal.
+    std::optional<CustomVector<double, DOFs>> position_tolerance, velocity_tolerance, acceleration_tolerance;
+
+    //! Optional per-DoF tolerances of the target state for using a precomputed trajectory: if the target state of the input
+    //! deviates from the predicted target state within these tolerances, the precomputed trajectory is used as well.
+    std::optional<CustomVector<double, DOFs>> target_position_tolerance, target_velocity_tolerance, target_acceleration_tolerance;
+
+    //! Number of updates that kept the trajectory as the current state was within the tolerances
+    size_t tolerated_update_counter {0};
+
+    //! Number of updates that used the precomputed trajectory of a matching predicted input
+    size_t precomputed_update_counter {0};
+
     template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
     explicit Ruckig():
         max_number_of_waypoints(0),
@@ -61,7 +197,10 @@ public:
     template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
     explicit Ruckig(double delta_time, size_t max_number_of_waypoints):
         current_input(InputParameter<DOFs, CustomVector>(max_number_of_waypoints)),
+        precomputed_input(InputParameter<DOFs, CustomVector>(max_number_of_waypoints)),
+        precomputed_trajectory(Trajectory<DOFs, CustomVector>(max_number_of_waypoints)),
         calculator(Calculator<DOFs, CustomVector>(max_number_of_waypoints)),
+        precompute_calculator(Calculator<DOFs, CustomVector>(max_number_of_waypoints)),
         max_number_of_waypoints(max_number_of_waypoints),
         degrees_of_freedom(DOFs),
         delta_time(delta_time)
@@ -72,7 +211,10 @@ public:
     template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
     explicit Ruckig(size_t dofs):
         current_input(InputParameter<DOFs, CustomVector>(dofs)),
+        precomputed_input(InputParameter<DOFs, CustomVector>(dofs)),
+        precomputed_trajectory(Trajectory<DOFs, CustomVector>(dofs)),
         calculator(Calculator<DOFs, CustomVector>(dofs)),
+        precompute_calculator(Calculator<DOFs, CustomVector>(dofs)),
         max_number_of_waypoints(0),
         degrees_of_freedom(dofs),
         delta_time(-1.0)
@@ -82,7 +224,10 @@ public:
     template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
     explicit Ruckig(size_t dofs, double delta_time):
         current_input(InputParameter<DOFs, CustomVector>(dofs)),
+        precomputed_input(InputParameter<DOFs, CustomVector>(dofs)),
+        precomputed_trajectory(Trajectory<DOFs, CustomVector>(dofs)),
         calculator(Calculator<DOFs, CustomVector>(dofs)),
+        precompute_calculator(Calculator<DOFs, CustomVector>(dofs)),
         max_number_of_waypoints(0),
         degrees_of_freedom(dofs),
         delta_time(delta_time)
@@ -93,7 +238,10 @@ public:
     template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
     explicit Ruckig(size_t dofs, double delta_time, size_t max_number_of_waypoints):
         current_input(InputParameter<DOFs, CustomVector>(dofs, max_number_of_waypoints)),
+        precomputed_input(InputParameter<DOFs, CustomVector>(dofs, max_number_of_waypoints)),
+        precomputed_trajectory(Trajectory<DOFs, CustomVector>(dofs, max_number_of_waypoints)),
         calculator(Calculator<DOFs, CustomVector>(dofs, max_number_of_waypoints)),
+        precompute_calculator(Calculator<DOFs, CustomVector>(dofs, max_number_of_waypoints)),
         max_number_of_waypoints(max_number_of_waypoints),
         degrees_of_freedom(dofs),
         delta_time(delta_time)
@@ -104,6 +252,46 @@ public:
     //! Reset the instance (e.g. to force a new calculation in the next update)
     void reset() {
         current_input_initialized = false;
+        tolerated_update_counter = 0;
+        precomputed_update_counter = 0;
+        has_precomputed_input = false;
+    }
+
+    //! Predict the input of the next update from the current input and the output of the current update: the current state is
+    //! the new state of the output, and the target state moves with its target velocity and acceleration for one time step.
+    void predict_input(const InputParameter<DOFs, CustomVector>& input, const OutputParameter<DOFs, CustomVector>& output, InputParameter<DOFs, CustomVector>& predicted_input) const {
+        predicted_input = input;
+        output.pass_to_input(predicted_input);
+        for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
+            std::tie(predicted_input.target_position[dof], predicted_input.target_velocity[dof], predicted_input.target_acceleration[dof]) = integrate(delta_time, input.target_position[dof], input.target_velocity[dof], input.target_acceleration[dof], 0.0);
+        }
+    }
+
+    //! Precompute the trajectory for a predicted input of a following update (see predict_input), e.g. in the idle time of the current
+    //! cycle. If the input of an update equals the predicted input (or matches it within the tolerances of the current and target state),
+    //! the precomputed trajectory is used. The calculation uses the separate precompute_calculator and doesn't allocate.
+    Result precompute(const InputParameter<DOFs, CustomVector>& predicted_input) {
+        has_precomputed_input = false;
+        if (!validate_input<throw_error>(predicted_input, false, true)) {
+            return Result::ErrorInvalidInput;
+        }
+
+        bool was_interrupted {false};
+        const Result result = precompute_calculator.template calculate<throw_error>(predicted_input, precomputed_trajectory, delta_time, was_interrupted);
+        if (result == Result::Working) {
+            precomputed_input = predicted_input;
+            has_precomputed_input = true;
+        }
+        return result;
+    }
+
+    //! Set a trajectory that was precomputed elsewhere (e.g. by another instance in a helper thread) for a predicted input. The trajectory
+    //! is swapped with the preallocated one instead of copied, so that it doesn't allocate. This is not synchronized with update, so call
+    //! it from the same thread after receiving the trajectory (e.g. from a TrajectoryBuffer).
+    void set_precomputed(const InputParameter<DOFs, CustomVector>& predicted_input, Trajectory<DOFs, CustomVector>& trajectory) {
+        std::swap(precomputed_trajectory, trajectory);
+        precomputed_input = predicted_input;
+        has_precomputed_input = true;
     }
 
     //! Filter intermediate positions based on a threshold distance for each DoF
@@ -210,6 +398,71 @@ public:
         return calculator.template calculate<throw_error>(input, trajectory, delta_time, was_interrupted);
     }
 
+    //! Calculate the minimal duration and blocked intervals of each DoF (Step 1), e.g. to find a common duration with other instances.
+    //! The trajectory is prepared for a subsequent calculate_step2 call with the same input. Intermediate positions are ignored.
+    Result calculate_step1(const InputParameter<DOFs, CustomVector>& input, Trajectory<DOFs, CustomVector>& trajectory) {
+        if (!validate_input<throw_error>(input, false, true)) {
+            return Result::ErrorInvalidInput;
+        }
+
+        calculator.target_calculator.calculate_brakes(input, trajectory);
+        return calculator.target_calculator.template calculate_step1<throw_error>(input, trajectory);
+    }
+
+    //! Get the minimal duration and blocked intervals of each DoF from the last calculation
+    const StandardVector<Block, DOFs>& get_blocks() const {
+        return calculator.target_calculator.get_blocks();
+    }
+
+    //! Calculate the trajectory for a given duration that is valid for all synchronized DoFs (Step 2 only, after calculate_step1 with the
+    //! same input). Returns an error if the input differs from the one of the last Step 1.
+    Result calculate_step2(const InputParameter<DOFs, CustomVector>& input, Trajectory<DOFs, CustomVector>& trajectory, double duration) {
+        return calculator.target_calculator.template calculate_step2_for_duration<throw_error>(input, trajectory, duration, delta_time);
+    }
+
+    //! Re-time a trajectory to a new duration without recalculating Step 1. The input needs to be the same as in the last calculation of
+    //! this instance. Returns an error if the new duration is shorter than the minimal duration or within a blocked interval of a DoF.
+    Result retime(const InputParameter<DOFs, CustomVector>& input, Trajectory<DOFs, CustomVector>& trajectory, double duration) {
+        return calculator.target_calculator.template retime<throw_error>(input, trajectory, duration, delta_time);
+    }
+
+    //! Calculate the trajectory with the smallest scale of the limits that reaches the target within the given duration. The velocity
+    //! limits are scaled by the factor, the acceleration limits by its square, and the jerk limits by its cube. Intermediate positions are ignored.
+    //! Returns ErrorSynchronizationCalculation if the duration can't be reached within the original limits.
+    Result calculate_limit_scale(const InputParameter<DOFs, CustomVector>& input, double duration, Trajectory<DOFs, CustomVector>& trajectory, double& scale) {
+        if (!validate_input<throw_error>(input, false, true)) {
+            return Result::ErrorInvalidInput;
+        }
+
+        return calculator.target_calculator.template calculate_limit_scale<throw_error>(input, duration, trajectory, delta_time, scale);
+    }
+
+    //! Calculate the trajectories from the current state of the input to many target states, optionally in parallel.
+    //! The limits and settings are taken from the input, while its target state and intermediate positions are ignored.
+    //! Invalid target states don't throw, but are reported per target as ErrorInvalidInput.
+    Result calculate(const InputParameter<DOFs, CustomVector>& input, const std::vector<KinematicState<DOFs, CustomVector>>& targets, std::vector<Trajectory<DOFs, CustomVector>>& trajectories, std::vector<Result>& results, size_t number_of_threads = 1) {
+        std::vector<double> durations;
+        return calculate_batch(input, targets, false, &trajectories, durations, results, number_of_threads);
+    }
+
+    //! Calculate only the trajectory durations from the current state of the input to many target states (skips Step 2)
+    Result calculate_durations(const InputParameter<DOFs, CustomVector>& input, const std::vector<KinematicState<DOFs, CustomVector>>& targets, std::vector<double>& durations, std::vector<Result>& results, size_t number_of_threads = 1) {
+        return calculate_batch(input, targets, false, nullptr, durations, results, number_of_threads);
+    }
+
+    //! Calculate the trajectories from many current states to the target state of the input, optionally in parallel.
+    //! The limits and settings are taken from the input, while its current state and intermediate positions are ignored.
+    //! Invalid current states don't throw, but are reported per state as ErrorInvalidInput.
+    Result calculate_from_current_states(const InputParameter<DOFs, CustomVector>& input, const std::vector<KinematicState<DOFs, CustomVector>>& current_states, std::vector<Trajectory<DOFs, CustomVector>>& trajectories, std::vector<Result>& results, size_t number_of_threads = 1) {
+        std::vector<double> durations;
+        return calculate_batch(input, current_states, true, &trajectories, durations, results, number_of_threads);
+    }
+
+    //! Calculate only the trajectory durations from many current states to the target state of the input (skips Step 2)
+    Result calculate_durations_from_current_states(const InputParameter<DOFs, CustomVector>& input, const std::vector<KinematicState<DOFs, CustomVector>>& current_states, std::vector<double>& durations, std::vector<Result>& results, size_t number_of_threads = 1) {
+        return calculate_batch(input, current_states, true, nullptr, durations, results, number_of_threads);
+    }
+
     //! Get the next output state (with step delta_time) along the calculated trajectory for the given input
     Result update(const InputParameter<DOFs, CustomVector>& input, OutputParameter<DOFs, CustomVector>& output) {
         const auto start = std::chrono::steady_clock::now();
@@ -223,13 +476,35 @@ public:
         output.new_calculation = false;
 
         Result result {Result::Working};
-        if (!current_input_initialized || input != current_input) {
-            result = calculate(input, output.trajectory, output.was_calculation_interrupted);
+        const bool is_input_changed = !current_input_initialized || input != current_input;
+        if (is_input_changed && current_input_initialized && is_within_tolerance(input, current_input, false)) {
+            tolerated_update_counter += 1;
+
+        } else if (is_input_changed) {
+            const bool use_precomputed = has_precomputed_input && (!(input != precomputed_input) || is_within_tolerance(input, precomputed_input, true));
+            if (use_precomputed) {
+                std::swap(output.trajectory, precomputed_trajectory);
+                output.was_calculation_interrupted = false;
+                precomputed_update_counter += 1;
+
+            } else {
+                result = calculate(input, output.trajectory, output.was_calculation_interrupted);
+            }
+            has_precomputed_input = false;
+
             if (result != Result::Working && result != Result::ErrorPositionalLimits) {
                 return result;
             }
 
-            current_input = input;
+            if (use_precomputed) {
+                // The precomputed trajectory reaches the predicted target, so that a following update replans for a differing target
+                current_input = precomputed_input;
+                current_input.current_position = input.current_position;
+                current_input.current_velocity = input.current_velocity;
+                current_input.current_acceleration = input.current_acceleration;
+            } else {
+                current_input = input;
+            }
             current_input_initialized = true;
             output.time = 0.0;
             output.new_calculation = true;
@@ -259,3 +534,7 @@ using RuckigThrow = Ruckig<DOFs, CustomVector, true>;
 
 
 } // namespace ruckig
+
+#if defined RUCKIG_EXPLICIT_INSTANTIATION
+#include <ruckig/instantiation.hpp>
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include <ruckig/profile.hpp>
+
+
+namespace ruckig {
+
+//! Derivatives of the duration of a single DoF with respect to its target state and kinematic limits
+struct DurationSensitivity {
+    double target_position {0.0};
+    double target_velocity {0.0};
+    double target_acceleration {0.0};
+
+    double max_velocity {0.0};
+    double min_velocity {0.0};
+    double max_acceleration {0.0};
+    double min_acceleration {0.0};
+    double max_jerk {0.0};
+
+    //! Set all derivatives to NaN, e.g. if they are not available
+    void set_unavailable();
+
+    //! Calculate the derivatives of the duration of a time-optimal third-order position profile by implicit differentiation
+    //! of its active constraints. Returns false (and sets NaN) if the profile is degenerate, e.g. if a constraint becomes active
+    //! exactly at a phase boundary. If the profile has a brake pre-trajectory, only the target derivatives are available.
+    bool calculate(const Profile& profile, double vMax, double vMin, double aMax, double aMin, double jMax);
+};
+
+} // namespace ruckig
@@ -35,6 +35,7 @@ class Trajectory {
     Container<double> cumulative_times;
 
     Vector<double> independent_min_durations;
+    Vector<double> group_durations;
     Vector<Bound> position_extrema;
 
     size_t continue_calculation_counter {0};
@@ -156,6 +157,7 @@ public:
 
         profiles[0].resize(dofs);
         independent_min_durations.resize(dofs);
+        group_durations.resize(dofs);
         position_extrema.resize(dofs);
     }
 
@@ -170,6 +172,7 @@ public:
         resize(max_number_of_waypoints);
 
         independent_min_durations.resize(dofs);
+        group_durations.resize(dofs);
         position_extrema.resize(dofs);
     }
 #endif
@@ -265,6 +268,11 @@ public:
         return independent_min_durations;
     }
 
+    //! Get the duration of the synchronization group of each DoF (only with per-DoF synchronization groups)
+    Vector<double> get_group_durations() const {
+        return group_durations;
+    }
+
     //! Get the min/max values of the position for each DoF
     Vector<Bound> get_position_extrema() {
         for (size_t dof = 0; dof < degrees_of_freedom; ++dof) {
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <ruckig/input_parameter.hpp>
+#include <ruckig/result.hpp>
+#include <ruckig/trajectory.hpp>
+
+
+namespace ruckig {
+
+//! @brief Lock-free triple buffer to hand over trajectories from a (non-real-time) planning thread to the real-time thread
+//!
+//! The planning thread calculates a new trajectory from the state that its last published trajectory predicts at a future
+//! start time. The real-time thread switches to the new trajectory once the start time is reached, without blocking or
+//! allocating. A new trajectory is only published after the real-time thread took the previous one, so that each switch is
+//! continuous as long as the start time lies in the future of the real-time thread. The buffer is used standalone instead of
+//! Ruckig::update and the OutputParameter: the real-time thread samples the current trajectory with at_time().
+template<size_t DOFs, template<class, size_t> class CustomVector = StandardVector>
+class TrajectoryBuffer {
+    template<class T> using Vector = CustomVector<T, DOFs>;
+
+    constexpr static uint8_t index_mask {0b011};
+    constexpr static uint8_t new_flag {0b100};
+
+    std::array<Trajectory<DOFs, CustomVector>, 3> trajectories;
+    std::array<std::atomic<double>, 3> start_times;
+
+    //! Index of the exchanged (middle) buffer, and a flag if it holds a new trajectory
+    std::atomic<uint8_t> middle {1};
+
+    // Owned by the planning thread. The last published buffer is only read, as the real-time thread doesn't write trajectories
+    uint8_t back {0};
+    uint8_t last {1};
+    bool has_last_trajectory {false};
+
+    // Owned by the real-time thread
+    uint8_t front {2};
+    bool has_front_trajectory {false};
+
+    //! Planning thread: publish the trajectory in the back buffer, and take the previous middle buffer as new back buffer
+    void publish_back(double start_time) {
+        start_times[back].store(start_time, std::memory_order_relaxed);
+        last = back;
+        has_last_trajectory = true;
+
+        back = middle.exchange(back | new_flag, std::memory_order_acq_rel) & index_mask;
+    }
+
+public:
+    template<size_t D = DOFs, typename std::enable_if<(D >= 1), int>::type = 0>
+    explicit TrajectoryBuffer() {
+        for (auto& start_time: start_times) {
+            start_time.store(0.0);
+        }
+    }
+
+    template<size_t D = DOFs, typename std::enable_if<(D == 0), int>::type = 0>
+    explicit TrajectoryBuffer(size_t dofs):
+        trajectories({Trajectory<DOFs, CustomVector>(dofs), Trajectory<DOFs, CustomVector>(dofs), Trajectory<DOFs, CustomVector>(dofs)})
+    {
+        for (auto& start_time: start_times) {
+            start_time.store(0.0);
+        }
+    }
+
+    //! Planning thread: is a published trajectory still waiting for the real-time thread?
+    bool is_pending() const {
+        return middle.load(std::memory_order_acquire) & new_flag;
+    }
+
+    //! Planning thread: publish a trajectory that starts at the given (absolute) time of the real-time thread
+    void publish(const Trajectory<DOFs, CustomVector>& trajectory, double start_time) {
+        trajectories[back] = trajectory;
+        publish_back(start_time);
+    }
+
+    //! Planning thread: calculate a trajectory starting at the given (absolute) time, and publish it. The current state of the input
+    //! is set to the state predicted by the last published trajectory. Returns Result::Error without calculation if the last
+    //! published trajectory is still pending.
+    template<class OTG>
+    Result plan(OTG& otg, InputParameter<DOFs, CustomVector>& input, double start_time) {
+        if (is_pending()) {
+            return Result::Error;
+        }
+
+        if (has_last_trajectory) {
+            const double last_start_time = start_times[last].load(std::memory_order_relaxed);
+            trajectories[last].at_time(start_time - last_start_time, input.current_position, input.current_velocity, input.current_acceleration);
+        }
+
+        // Calculate into the back buffer directly, so that publishing doesn't copy
+        const Result result = otg.calculate(input, trajectories[back]);
+        if (result == Result::Working) {
+            publish_back(start_time);
+        }
+        return result;
+    }
+
+    //! Real-time thread: switch to a new trajectory if one was published and its start time is reached. Never blocks or allocates.
+    bool update(double time) {
+        uint8_t state = middle.load(std::memory_order_acquire);
+        if (!(state & new_flag) || start_times[state & index_mask].load(std::memory_order_relaxed) > time) {
+            return false;
+        }
+
+        // Fails only if a newer trajectory was published in the meantime, which is then taken in the next cycle
+        if (!middle.compare_exchange_strong(state, front, std::memory_order_acq_rel)) {
+            return false;
+        }
+
+        front = state & index_mask;
+        has_front_trajectory = true;
+        return true;
+    }
+
+    //! Real-time thread: was any trajectory taken so far?
+    bool has_trajectory() const {
+        return has_front_trajectory;
+    }
+
+    //! Real-time thread: the current trajectory
+    const Trajectory<DOFs, CustomVector>& get_trajectory() const {
+        return trajectories[front];
+    }
+
+    //! Real-time thread: the (absolute) start time of the current trajectory
+    double get_start_time() const {
+        return start_times[front].load(std::memory_order_relaxed);
+    }
+
+    //! Real-time thread: get the kinematic state of the current trajectory at the given (absolute) time
+    void at_time(double time, Vector<double>& new_position, Vector<double>& new_velocity, Vector<double>& new_acceleration) const {
+        get_trajectory().at_time(time - get_start_time(), new_position, new_velocity, new_acceleration);
+    }
+};
+
+} // namespace ruckig
@@ -0,0 +1,8 @@
+#include <ruckig/instantiation.hpp>
+
+
+namespace ruckig {
+
+RUCKIG_INSTANTIATE()
+
+} // namespace ruckig
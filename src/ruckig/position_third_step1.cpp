@@ -1,4 +1,5 @@
 #include <ruckig/block.hpp>
+#include <ruckig/block_cache.hpp>
 #include <ruckig/position.hpp>
 
 
@@ -538,6 +539,23 @@ bool PositionThirdOrderStep1::get_profile(const Profile& input, Block& block) {
         if (std::abs(v0) < DBL_EPSILON && std::abs(a0) < DBL_EPSILON && std::abs(pd) < DBL_EPSILON) {
             time_all_none_acc0_acc1(profile, vMax, vMin, aMax, aMin, jMax, true);
 
+        } else if (family_statistics) {
+            // The first found profile is the only valid one, so the families can be tried in any order
+            for (const size_t family: family_statistics->step1_order) {
+                switch (family) {
+                    case 0: time_all_vel(profile, vMax, vMin, aMax, aMin, jMax, true); break;
+                    case 1: time_all_none_acc0_acc1(profile, vMax, vMin, aMax, aMin, jMax, true); break;
+                    case 2: time_acc0_acc1(profile, vMax, vMin, aMax, aMin, jMax, true); break;
+                    case 3: time_all_vel(profile, vMin, vMax, aMin, aMax, -jMax, true); break;
+                    case 4: time_all_none_acc0_acc1(profile, vMin, vMax, aMin, aMax, -jMax, true); break;
+                    case 5: time_acc0_acc1(profile, vMin, vMax, aMin, aMax, -jMax, true); break;
+                }
+                if (profile > start) {
+                    family_statistics->record_step1(family);
+                    goto return_block;
+                }
+            }
+
         } else {
             // There is no blocked interval when vf==0 && af==0, so return after first found profile
             time_all_vel(profile, vMax, vMin, aMax, aMin, jMax, true);
@@ -585,4 +603,91 @@ return_block:
     return Block::calculate_block(block, valid_profiles, std::distance(start, profile));
 }
 
+//! Scale the timing of a normalized profile back and integrate it along the original boundary state
+inline bool denormalize_profile(const Profile& normalized, const Profile& input, double time_scale, double vMax, double vMin, double aMax, double aMin, double jMax, Profile& profile) {
+    using ControlSigns = Profile::ControlSigns;
+    using ReachedLimits = Profile::ReachedLimits;
+
+    profile.set_boundary(input);
+    for (size_t i = 0; i < 7; ++i) {
+        profile.t[i] = normalized.t[i] * time_scale;
+    }
+
+    // Step 1 only finds UDDU profiles with maximal jerk
+    if (normalized.direction == Profile::Direction::DOWN) {
+        std::swap(vMax, vMin);
+        std::swap(aMax, aMin);
+        jMax = -jMax;
+    }
+
+    switch (normalized.limits) {
+        case ReachedLimits::ACC0_ACC1_VEL: return profile.check<ControlSigns::UDDU, ReachedLimits::ACC0_ACC1_VEL>(jMax, vMax, vMin, aMax, aMin);
+        case ReachedLimits::VEL: return profile.check<ControlSigns::UDDU, ReachedLimits::VEL>(jMax, vMax, vMin, aMax, aMin);
+        case ReachedLimits::ACC0: return profile.check<ControlSigns::UDDU, ReachedLimits::ACC0>(jMax, vMax, vMin, aMax, aMin);
+        case ReachedLimits::ACC1: return profile.check<ControlSigns::UDDU, ReachedLimits::ACC1>(jMax, vMax, vMin, aMax, aMin);
+        case ReachedLimits::ACC0_ACC1: return profile.check<ControlSigns::UDDU, ReachedLimits::ACC0_ACC1>(jMax, vMax, vMin, aMax, aMin);
+        case ReachedLimits::ACC0_VEL: return profile.check<ControlSigns::UDDU, ReachedLimits::ACC0_VEL>(jMax, vMax, vMin, aMax, aMin);
+        case ReachedLimits::ACC1_VEL: return profile.check<ControlSigns::UDDU, ReachedLimits::ACC1_VEL>(jMax, vMax, vMin, aMax, aMin);
+        case ReachedLimits::NONE: return profile.check<ControlSigns::UDDU, ReachedLimits::NONE>(jMax, vMax, vMin, aMax, aMin);
+    }
+    return false;
+}
+
+bool PositionThirdOrderStep1::get_normalized_profile(const Profile& input, Block& block, BlockCache* cache) {
+    // Zero limits can't be normalized
+    if (_jMax == 0.0 || _aMax == 0.0 || _aMin == 0.0) {
+        return get_profile(input, block);
+    }
+
+    // Units of time, velocity, and position so that the normalized aMax and jMax are one
+    const double time_scale = _aMax / _jMax;
+    const double velocity_scale = _aMax * time_scale;
+    const double position_scale = velocity_scale * time_scale;
+
+    const BlockCache::Key key {0.0, v0 / velocity_scale, a0 / _aMax, pd / position_scale, vf / velocity_scale, af / _aMax, _vMax / velocity_scale, _vMin / velocity_scale, 1.0, _aMin / _aMax, 1.0};
+
+    Block normalized_block;
+    const Block* normalized = cache ? cache->find(key) : nullptr;
+    if (!normalized) {
+        Profile normalized_input;
+        normalized_input.set_boundary(key[0], key[1], key[2], key[3], key[4], key[5]);
+
+        PositionThirdOrderStep1 step1 {key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7], key[8], key[9], key[10]};
+        step1.family_statistics = family_statistics;
+        if (!step1.get_profile(normalized_input, normalized_block)) {
+            return get_profile(input, block);
+        }
+
+        if (cache) {
+            cache->insert(key, normalized_block);
+        }
+        normalized = &normalized_block;
+    }
+
+    // The normalized problem has no brake, so the original brake is added to all durations
+    const double brake_duration = input.brake.duration + input.accel.duration;
+    if (!denormalize_profile(normalized->p_min, input, time_scale, _vMax, _vMin, _aMax, _aMin, _jMax, block.p_min)) {
+        return get_profile(input, block);
+    }
+    block.t_min = block.p_min.t_sum.back() + brake_duration;
+
+    block.a = std::nullopt;
+    block.b = std::nullopt;
+    for (auto [normalized_interval, interval]: {std::make_pair(&normalized->a, &block.a), std::make_pair(&normalized->b, &block.b)}) {
+        if (!*normalized_interval) {
+            continue;
+        }
+
+        Profile profile;
+        if (!denormalize_profile((*normalized_interval)->profile, input, time_scale, _vMax, _vMin, _aMax, _aMin, _jMax, profile)) {
+            return get_profile(input, block);
+        }
+
+        *interval = Block::Interval((*normalized_interval)->left * time_scale + brake_duration, profile.t_sum.back() + brake_duration);
+        (*interval)->profile = profile;
+    }
+
+    return true;
+}
+
 } // namespace ruckig
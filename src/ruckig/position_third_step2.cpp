@@ -90,6 +90,7 @@ bool PositionThirdOrderStep2::time_acc1_vel(Profile& profile, double vMax, doubl
         const double t_min = -a0/jMax;
         const double t_max = std::min((tf + 2*aMin/jMax - (a0 + af)/jMax)/2, (aMax - a0)/jMax);
 
+        ProfileCandidates<4> candidates;
         auto roots = roots::solve_quart_monic(polynom);
         for (double t: roots) {
             if (t < t_min || t > t_max) {
@@ -107,17 +108,19 @@ bool PositionThirdOrderStep2::time_acc1_vel(Profile& profile, double vMax, doubl
 
             const double h1 = -((a0_a0 + af_af)/2 + jMax*(-vd + 2*a0*t + jMax*t*t))/aMin;
 
-            profile.t[0] = t;
-            profile.t[1] = 0;
-            profile.t[2] = a0/jMax + t;
-            profile.t[3] = tf - (h1 - aMin + a0 + af)/jMax - 2*t;
-            profile.t[4] = -aMin/jMax;
-            profile.t[5] = (h1 + aMin)/jMax;
-            profile.t[6] = profile.t[4] + af/jMax;
+            candidates.add(ControlSigns::UDDU, {
+                t,
+                0,
+                a0/jMax + t,
+                tf - (h1 - aMin + a0 + af)/jMax - 2*t,
+                -aMin/jMax,
+                (h1 + aMin)/jMax,
+                -aMin/jMax + af/jMax
+            });
+        }
 
-            if (profile.check_with_timing<ControlSigns::UDDU, ReachedLimits::ACC1_VEL>(tf, jMax, vMax, vMin, aMax, aMin)) {
-                return true;
-            }
+        if (candidates.check_with_timing<ReachedLimits::ACC1_VEL>(profile, tf, jMax, vMax, vMin, aMax, aMin)) {
+            return true;
         }
     }
 
@@ -137,6 +140,7 @@ bool PositionThirdOrderStep2::time_acc1_vel(Profile& profile, double vMax, doubl
         const double t_min = -a0/jMax;
         const double t_max = std::min((tf + ad/jMax - 2*aMax/jMax)/2, (aMax - a0)/jMax);
 
+        ProfileCandidates<4> candidates;
         auto roots = roots::solve_quart_monic(polynom);
         for (double t: roots) {
             if (t > t_max || t < t_min) {
@@ -145,17 +149,19 @@ bool PositionThirdOrderStep2::time_acc1_vel(Profile& profile, double vMax, doubl
 
             const double h1 = ((a0_a0 - af_af)/2 + jMax_jMax*t*t - jMax*(vd - 2*a0*t))/aMax;
 
-            profile.t[0] = t;
-            profile.t[1] = 0;
-            profile.t[2] = t + a0/jMax;
-            profile.t[3] = tf + (h1 + ad - aMax)/jMax - 2*t;
-            profile.t[4] = aMax/jMax;
-            profile.t[5] = -(h1 + aMax)/jMax;
-            profile.t[6] = profile.t[4] - af/jMax;
+            candidates.add(ControlSigns::UDUD, {
+                t,
+                0,
+                t + a0/jMax,
+                tf + (h1 + ad - aMax)/jMax - 2*t,
+                aMax/jMax,
+                -(h1 + aMax)/jMax,
+                aMax/jMax - af/jMax
+            });
+        }
 
-            if (profile.check_with_timing<ControlSigns::UDUD, ReachedLimits::ACC1_VEL>(tf, jMax, vMax, vMin, aMax, aMin)) {
-                return true;
-            }
+        if (candidates.check_with_timing<ReachedLimits::ACC1_VEL>(profile, tf, jMax, vMax, vMin, aMax, aMin)) {
+            return true;
         }
     }
 
@@ -180,6 +186,7 @@ bool PositionThirdOrderStep2::time_acc0_vel(Profile& profile, double vMax, doubl
         const double t_min = -af/jMax;
         const double t_max = std::min(tf - (2*aMax - a0)/jMax, -aMin/jMax);
 
+        ProfileCandidates<4> candidates;
         auto roots = roots::solve_quart_monic(polynom);
         for (double t: roots) {
             if (t < t_min || t > t_max) {
@@ -197,17 +204,19 @@ bool PositionThirdOrderStep2::time_acc0_vel(Profile& profile, double vMax, doubl
 
             const double h1 = ((a0_a0 - af_af)/2 + jMax*(jMax*t*t + vd))/aMax;
 
-            profile.t[0] = (-a0 + aMax)/jMax;
-            profile.t[1] = (h1 - aMax)/jMax;
-            profile.t[2] = aMax/jMax;
-            profile.t[3] = tf - (h1 + ad + aMax)/jMax - 2*t;
-            profile.t[4] = t;
-            profile.t[5] = 0;
-            profile.t[6] = af/jMax + t;
+            candidates.add(ControlSigns::UDDU, {
+                (-a0 + aMax)/jMax,
+                (h1 - aMax)/jMax,
+                aMax/jMax,
+                tf - (h1 + ad + aMax)/jMax - 2*t,
+                t,
+                0,
+                af/jMax + t
+            });
+        }
 
-            if (profile.check_with_timing<ControlSigns::UDDU, ReachedLimits::ACC0_VEL>(tf, jMax, vMax, vMin, aMax, aMin)) {
-                return true;
-            }
+        if (candidates.check_with_timing<ReachedLimits::ACC0_VEL>(profile, tf, jMax, vMax, vMin, aMax, aMin)) {
+            return true;
         }
     }
 
@@ -222,6 +231,7 @@ bool PositionThirdOrderStep2::time_acc0_vel(Profile& profile, double vMax, doubl
         const double t_min = af/jMax;
         const double t_max = std::min(tf - aMax/jMax, aMax/jMax);
 
+        ProfileCandidates<4> candidates;
         auto roots = roots::solve_quart_monic(polynom);
         for (double t: roots) {
             if (t < t_min || t > t_max) {
@@ -239,17 +249,19 @@ bool PositionThirdOrderStep2::time_acc0_vel(Profile& profile, double vMax, doubl
 
             const double h1 = ((a0_a0 + af_af)/2 + jMax*(vd - jMax*t*t))/aMax;
 
-            profile.t[0] = (-a0 + aMax)/jMax;
-            profile.t[1] = (h1 - aMax)/jMax;
-            profile.t[2] = aMax/jMax;
-            profile.t[3] = tf - (h1 - a0 - af + aMax)/jMax - 2*t;
-            profile.t[4] = t;
-            profile.t[5] = 0;
-            profile.t[6] = -(af/jMax) + t;
+            candidates.add(ControlSigns::UDUD, {
+                (-a0 + aMax)/jMax,
+                (h1 - aMax)/jMax,
+                aMax/jMax,
+                tf - (h1 - a0 - af + aMax)/jMax - 2*t,
+                t,
+                0,
+                -(af/jMax) + t
+            });
+        }
 
-            if (profile.check_with_timing<ControlSigns::UDUD, ReachedLimits::ACC0_VEL>(tf, jMax, vMax, vMin, aMax, aMin)) {
-                return true;
-            }
+        if (candidates.check_with_timing<ReachedLimits::ACC0_VEL>(profile, tf, jMax, vMax, vMin, aMax, aMin)) {
+            return true;
         }
     }
 
@@ -268,6 +280,7 @@ bool PositionThirdOrderStep2::time_vel(Profile& profile, double vMax, double vMi
         polynom[2] = 0;
         polynom[3] = pd/(2*jMax);
 
+        ProfileCandidates<3> candidates;
         auto roots = roots::solve_cubic(polynom[0], polynom[1], polynom[2], polynom[3]);
         for (double t: roots) {
             if (t > tf/4) {
@@ -281,17 +294,19 @@ bool PositionThirdOrderStep2::time_vel(Profile& profile, double vMax, double vMi
                 t -= orig / deriv;
             }
 
-            profile.t[0] = t;
-            profile.t[1] = 0;
-            profile.t[2] = t;
-            profile.t[3] = tf - 4*t;
-            profile.t[4] = t;
-            profile.t[5] = 0;
-            profile.t[6] = t;
+            candidates.add(ControlSigns::UDDU, {
+                t,
+                0,
+                t,
+                tf - 4*t,
+                t,
+                0,
+                t
+            });
+        }
 
-            if (profile.check_with_timing<ControlSigns::UDDU, ReachedLimits::VEL>(tf, jMax, vMax, vMin, aMax, aMin)) {
-                return true;
-            }
+        if (candidates.check_with_timing<ReachedLimits::VEL>(profile, tf, jMax, vMax, vMin, aMax, aMin)) {
+            return true;
         }
 
     } else {
@@ -735,6 +750,7 @@ bool PositionThirdOrderStep2::time_none(Profile& profile, double vMax, double vM
                 polynom[2] = 4*(pd - tf*vf)/jMax;
                 polynom[3] = (vd_vd + jMax*tf*g2)/(jMax_jMax);
 
+                ProfileCandidates<4> candidates;
                 auto roots = roots::solve_quart_monic(polynom);
                 for (double t: roots) {
                     if (t > tf/2 || t > (aMax - a0)/jMax) {
@@ -751,17 +767,21 @@ bool PositionThirdOrderStep2::time_none(Profile& profile, double vMax, double vM
                         t -= orig / deriv;
                     }
 
-                    profile.t[0] = t;
-                    profile.t[1] = 0;
-                    profile.t[2] = (jMax*t*(t - tf) + vd)/(jMax*(2*t - tf));
-                    profile.t[3] = tf - 2*t;
-                    profile.t[4] = t - profile.t[2];
-                    profile.t[5] = 0;
-                    profile.t[6] = 0;
+                    const double t2 = (jMax*t*(t - tf) + vd)/(jMax*(2*t - tf));
+
+                    candidates.add(ControlSigns::UDDU, {
+                        t,
+                        0,
+                        t2,
+                        tf - 2*t,
+                        t - t2,
+                        0,
+                        0
+                    });
+                }
 
-                    if (profile.check_with_timing<ControlSigns::UDDU, ReachedLimits::NONE>(tf, jMax, vMax, vMin, aMax, aMin)) {
-                        return true;
-                    }
+                if (candidates.check_with_timing<ReachedLimits::NONE>(profile, tf, jMax, vMax, vMin, aMax, aMin)) {
+                    return true;
                 }
             }
         }
@@ -802,6 +822,7 @@ bool PositionThirdOrderStep2::time_none(Profile& profile, double vMax, double vM
             const double t_min = ad/jMax;
             const double t_max = std::min((aMax - a0)/jMax, (ad/jMax + tf) / 2);
 
+            ProfileCandidates<4> candidates;
             auto roots = roots::solve_quart_monic(polynom);
             for (double t: roots) {
                 if (t < t_min || t > t_max) {
@@ -819,17 +840,22 @@ bool PositionThirdOrderStep2::time_none(Profile& profile, double vMax, double vM
                     t -= orig / deriv;
                 }
 
-                profile.t[0] = t;
-                profile.t[1] = 0;
-                profile.t[2] = (ad_ad + 2*jMax*(-a0*tf - ad*t + jMax*t*(t - tf) + vd))/(2*jMax*(-ad + jMax*(2*t - tf)));
-                profile.t[3] = ad/jMax + tf - 2*t;
-                profile.t[4] = tf - (t + profile.t[2] + profile.t[3]);
-                profile.t[5] = 0;
-                profile.t[6] = 0;
+                const double t2 = (ad_ad + 2*jMax*(-a0*tf - ad*t + jMax*t*(t - tf) + vd))/(2*jMax*(-ad + jMax*(2*t - tf)));
+                const double t3 = ad/jMax + tf - 2*t;
+
+                candidates.add(ControlSigns::UDDU, {
+                    t,
+                    0,
+                    t2,
+                    t3,
+                    tf - (t + t2 + t3),
+                    0,
+                    0
+                });
+            }
 
-                if (profile.check_with_timing<ControlSigns::UDDU, ReachedLimits::NONE>(tf, jMax, vMax, vMin, aMax, aMin)) {
-                    return true;
-                }
+            if (candidates.check_with_timing<ReachedLimits::NONE>(profile, tf, jMax, vMax, vMin, aMax, aMin)) {
+                return true;
             }
         }
 
@@ -869,6 +895,7 @@ bool PositionThirdOrderStep2::time_none(Profile& profile, double vMax, double vM
 
             const double t_max = (a0 - aMin)/jMax;
 
+            ProfileCandidates<4> candidates;
             auto roots = roots::solve_quart_monic(polynom);
             for (double t: roots) {
                 if (t > t_max) {
@@ -889,17 +916,21 @@ bool PositionThirdOrderStep2::time_none(Profile& profile, double vMax, double vM
                 const double h1 = std::sqrt(2*ad_ad + 4*jMax*(ad*t + a0*tf + jMax*t*(t - tf) - vd))/std::abs(jMax);
 
                 // Solution 2 with aPlat
-                profile.t[0] = 0;
-                profile.t[1] = 0;
-                profile.t[2] = t;
-                profile.t[3] = tf - 2*t - ad/jMax - h1;
-                profile.t[4] = h1/2;
-                profile.t[5] = 0;
-                profile.t[6] = tf - (t + profile.t[3] + profile.t[4]);
-
-                if (profile.check_with_timing<ControlSigns::UDDU, ReachedLimits::NONE>(tf, jMax, vMax, vMin, aMax, aMin)) {
-                    return true;
-                }
+                const double t3 = tf - 2*t - ad/jMax - h1;
+
+                candidates.add(ControlSigns::UDDU, {
+                    0,
+                    0,
+                    t,
+                    t3,
+                    h1/2,
+                    0,
+                    tf - (t + t3 + h1/2)
+                });
+            }
+
+            if (candidates.check_with_timing<ReachedLimits::NONE>(profile, tf, jMax, vMax, vMin, aMax, aMin)) {
+                return true;
             }
         }
     }
@@ -923,6 +954,7 @@ bool PositionThirdOrderStep2::time_none(Profile& profile, double vMax, double vM
             polynom[2] = (-a0_p5 + af_p5 - af_p4*jMax*tf + 5*a0_p4*(af - jMax*tf) - 2*a0_p3*ph3 - 4*af_p3*jMax*(jMax*tf_tf + vd) + 12*af_af*jMax_jMax*g2 - 12*af*jMax_jMax*ph6 + 2*a0_a0*(5*af_p3 - 9*af_af*jMax*tf - 6*af*jMax*vd + 6*jMax_jMax*ph0) + 12*jMax_jMax*jMax*ph2 + a0*(-5*af_p4 + 8*af_p3*jMax*tf + 12*af_af*jMax*(jMax*tf_tf + vd) - 24*af*jMax_jMax*(-2*pd + jMax*tf_p3 + 2*tf*vf) + 6*jMax_jMax*ph4))/(jMax*ph7);
             polynom[3] = -(a0_p6 + af_p6 - 6*a0_p5*(af - jMax*tf) + 48*af_p3*jMax_jMax*g1 - 72*jMax_jMax*jMax*(jMax*g1*g1 + vd_vd*vd + 2*af*g1*vd) + 3*a0_p4*ph3 - 6*af_p4*jMax*vd + 36*af_af*jMax_jMax*vd_vd - 4*a0_p3*(5*af_p3 - 9*af_af*jMax*tf - 6*af*jMax*vd + 6*jMax_jMax*ph0) + 3*a0_a0*ph5 - 6*a0*(af_p5 - af_p4*jMax*tf - 4*af_p3*jMax*(jMax*tf_tf + vd) + 12*jMax_jMax*(af_af*g2 - af*ph6 + jMax*ph2)))/(6*jMax_jMax*ph7);
 
+            ProfileCandidates<4> candidates;
             auto roots = roots::solve_quart_monic(polynom);
             for (double t: roots) {
                 if (t > tf || t > (aMax - a0)/jMax) {
@@ -931,17 +963,19 @@ bool PositionThirdOrderStep2::time_none(Profile& profile, double vMax, double vM
 
                 const double h1 = std::sqrt(ad_ad/(2*jMax_jMax) + (a0*(t + tf) - af*t + jMax*t*tf - vd)/jMax);
 
-                profile.t[0] = t;
-                profile.t[1] = tf - ad/jMax - 2*h1;
-                profile.t[2] = h1;
-                profile.t[3] = 0;
-                profile.t[4] = ad/jMax + h1 - t;
-                profile.t[5] = 0;
-                profile.t[6] = 0;
+                candidates.add(ControlSigns::UDUD, {
+                    t,
+                    tf - ad/jMax - 2*h1,
+                    h1,
+                    0,
+                    ad/jMax + h1 - t,
+                    0,
+                    0
+                });
+            }
 
-                if (profile.check_with_timing<ControlSigns::UDUD, ReachedLimits::NONE>(tf, jMax, vMax, vMin, aMax, aMin)) {
-                    return true;
-                }
+            if (candidates.check_with_timing<ReachedLimits::NONE>(profile, tf, jMax, vMax, vMin, aMax, aMin)) {
+                return true;
             }
         }
     }
@@ -1109,6 +1143,28 @@ bool PositionThirdOrderStep2::time_none_smooth(Profile& profile, double vMax, do
     return false;
 }
 
+bool PositionThirdOrderStep2::time_family(size_t family, Profile& profile, double vMax, double vMin, double aMax, double aMin, double jMax) {
+    switch (family) {
+        case 0: return time_acc0_acc1_vel(profile, vMax, vMin, aMax, aMin, jMax);
+        case 1: return time_vel(profile, vMax, vMin, aMax, aMin, jMax);
+        case 2: return time_acc0_vel(profile, vMax, vMin, aMax, aMin, jMax);
+        case 3: return time_acc1_vel(profile, vMax, vMin, aMax, aMin, jMax);
+        case 4: return time_acc0_acc1_vel(profile, vMin, vMax, aMin, aMax, -jMax);
+        case 5: return time_vel(profile, vMin, vMax, aMin, aMax, -jMax);
+        case 6: return time_acc0_vel(profile, vMin, vMax, aMin, aMax, -jMax);
+        case 7: return time_acc1_vel(profile, vMin, vMax, aMin, aMax, -jMax);
+        case 8: return time_acc0_acc1(profile, vMax, vMin, aMax, aMin, jMax);
+        case 9: return time_acc0(profile, vMax, vMin, aMax, aMin, jMax);
+        case 10: return time_acc1(profile, vMax, vMin, aMax, aMin, jMax);
+        case 11: return time_none(profile, vMax, vMin, aMax, aMin, jMax);
+        case 12: return time_acc0_acc1(profile, vMin, vMax, aMin, aMax, -jMax);
+        case 13: return time_acc0(profile, vMin, vMax, aMin, aMax, -jMax);
+        case 14: return time_acc1(profile, vMin, vMax, aMin, aMax, -jMax);
+        case 15: return time_none(profile, vMin, vMax, aMin, aMax, -jMax);
+    }
+    return false;
+}
+
 bool PositionThirdOrderStep2::get_profile(Profile& profile) {
     // Test all cases to get ones that match
     // However we should guess which one is correct and try them first...
@@ -1126,6 +1182,17 @@ bool PositionThirdOrderStep2::get_profile(Profile& profile) {
         return true;
     }
 
+    // Every valid profile reaches the target at tf, so the families can be tried in any order
+    if (family_statistics) {
+        for (const size_t family: family_statistics->step2_order) {
+            if (time_family(family, profile, vMax, vMin, aMax, aMin, jMax)) {
+                family_statistics->record_step2(family);
+                return true;
+            }
+        }
+        return false;
+    }
+
     return time_acc0_acc1_vel(profile, vMax, vMin, aMax, aMin, jMax)
         || time_vel(profile, vMax, vMin, aMax, aMin, jMax)
         || time_acc0_vel(profile, vMax, vMin, aMax, aMin, jMax)
@@ -115,6 +115,7 @@ limited by velocity, acceleration, and jerk constraints.";
         .def_rw("duration_discretization", &InputParameter<DynamicDOFs>::duration_discretization)
         .def_rw("per_dof_control_interface", &InputParameter<DynamicDOFs>::per_dof_control_interface, nb::arg().none())
         .def_rw("per_dof_synchronization", &InputParameter<DynamicDOFs>::per_dof_synchronization, nb::arg().none())
+        .def_rw("per_dof_synchronization_group", &InputParameter<DynamicDOFs>::per_dof_synchronization_group, nb::arg().none())
         .def_rw("minimum_duration", &InputParameter<DynamicDOFs>::minimum_duration, nb::arg().none())
         .def_rw("per_section_minimum_duration", &InputParameter<DynamicDOFs>::per_section_minimum_duration, nb::arg().none())
         .def_rw("interrupt_calculation_duration", &InputParameter<DynamicDOFs>::interrupt_calculation_duration, nb::arg().none())
@@ -154,6 +155,17 @@ limited by velocity, acceleration, and jerk constraints.";
         .def_ro("max_number_of_waypoints", &RuckigThrow<DynamicDOFs>::max_number_of_waypoints)
         .def_ro("degrees_of_freedom", &RuckigThrow<DynamicDOFs>::degrees_of_freedom)
         .def_rw("delta_time", &RuckigThrow<DynamicDOFs>::delta_time)
+        .def_rw("position_tolerance", &RuckigThrow<DynamicDOFs>::position_tolerance, nb::arg().none())
+        .def_rw("velocity_tolerance", &RuckigThrow<DynamicDOFs>::velocity_tolerance, nb::arg().none())
+        .def_rw("acceleration_tolerance", &RuckigThrow<DynamicDOFs>::acceleration_tolerance, nb::arg().none())
+        .def_rw("target_position_tolerance", &RuckigThrow<DynamicDOFs>::target_position_tolerance, nb::arg().none())
+        .def_rw("target_velocity_tolerance", &RuckigThrow<DynamicDOFs>::target_velocity_tolerance, nb::arg().none())
+        .def_rw("target_acceleration_tolerance", &RuckigThrow<DynamicDOFs>::target_acceleration_tolerance, nb::arg().none())
+        .def_ro("tolerated_update_counter", &RuckigThrow<DynamicDOFs>::tolerated_update_counter)
+        .def_ro("precomputed_update_counter", &RuckigThrow<DynamicDOFs>::precomputed_update_counter)
+        .def("predict_input", &RuckigThrow<DynamicDOFs>::predict_input, "input"_a, "output"_a, "predicted_input"_a)
+        .def("precompute", &RuckigThrow<DynamicDOFs>::precompute, "predicted_input"_a)
+        .def("set_precomputed", &RuckigThrow<DynamicDOFs>::set_precomputed, "predicted_input"_a, "trajectory"_a)
         .def("reset", &RuckigThrow<DynamicDOFs>::reset)
         .def("validate_input", &RuckigThrow<DynamicDOFs>::validate_input<true>, "input"_a, "check_current_state_within_limits"_a=false, "check_target_state_within_limits"_a=true)
         .def("calculate", static_cast<Result (RuckigThrow<DynamicDOFs>::*)(const InputParameter<DynamicDOFs>&, Trajectory<DynamicDOFs>&)>(&RuckigThrow<DynamicDOFs>::calculate), "input"_a, "trajectory"_a)
@@ -0,0 +1,185 @@
+#include <tuple>
+
+#include <ruckig/sensitivity.hpp>
+
+
+namespace ruckig {
+
+namespace {
+
+//! Parameters of the implicit equations, in the order of their derivatives
+enum Parameter { TargetPosition, TargetVelocity, TargetAcceleration, MaxVelocity, MinVelocity, MaxAcceleration, MinAcceleration, MaxJerk, NumberOfParameters };
+
+//! A (linearized) equation F(t, parameters) = 0 of the profile
+struct Equation {
+    std::array<double, 7> d_t {};
+    std::array<double, NumberOfParameters> d_parameter {};
+};
+
+//! Propagate a perturbation of the kinematic state (p, v, a) along a jerk-controlled double integrator for the duration t
+inline std::array<double, 3> propagate(const std::array<double, 3>& delta, double t) {
+    return {delta[0] + t * (delta[1] + t * delta[2] / 2), delta[1] + t * delta[2], delta[2]};
+}
+
+} // namespace
+
+
+void DurationSensitivity::set_unavailable() {
+    constexpr double nan {std::numeric_limits<double>::quiet_NaN()};
+    target_position = target_velocity = target_acceleration = nan;
+    max_velocity = min_velocity = max_acceleration = min_acceleration = max_jerk = nan;
+}
+
+bool DurationSensitivity::calculate(const Profile& profile, double vMax, double vMin, double aMax, double aMin, double jMax) {
+    set_unavailable();
+    if (!(profile.t_sum.back() > 0.0) || std::isinf(jMax) || jMax <= 0.0) {
+        return false;
+    }
+
+    // Merge phases with the same jerk (separated by phases of zero duration) into sections, whose durations are the unknowns
+    std::array<double, 7> t, j;
+    size_t n {0};
+    for (size_t i = 0; i < 7; ++i) {
+        if (profile.t[i] <= 0.0) {
+            continue;
+        }
+        if (n > 0 && profile.j[i] == j[n - 1]) {
+            t[n - 1] += profile.t[i];
+            continue;
+        }
+        if (profile.j[i] != 0.0 && std::abs(std::abs(profile.j[i]) - jMax) > 1e-12 * jMax) {
+            return false;
+        }
+
+        t[n] = profile.t[i];
+        j[n] = profile.j[i];
+        n += 1;
+    }
+
+    // Kinematic state and time at the start of each section
+    std::array<double, 8> s, p, v, a;
+    s[0] = 0.0;
+    p[0] = profile.p[0];
+    v[0] = profile.v[0];
+    a[0] = profile.a[0];
+    for (size_t k = 0; k < n; ++k) {
+        s[k+1] = s[k] + t[k];
+        std::tie(p[k+1], v[k+1], a[k+1]) = integrate(t[k], p[k], v[k], a[k], j[k]);
+    }
+
+    // Derivatives of the kinematic state at the start of section k, with respect to the section durations and the jerk limit
+    auto set_state_derivative = [&](Equation& equation, size_t k, size_t order) {
+        for (size_t i = 0; i < k; ++i) {
+            const double dt_left = s[k] - s[i+1];
+            equation.d_t[i] = propagate({v[i+1], a[i+1], j[i]}, dt_left)[order];
+
+            const double sign = j[i] / jMax;
+            equation.d_parameter[MaxJerk] += sign * propagate({t[i] * t[i] * t[i] / 6, t[i] * t[i] / 2, t[i]}, dt_left)[order];
+        }
+    };
+
+    std::array<Equation, 3 + 2*7> equations;
+    size_t m {0};
+
+    // Final state reaches the target state
+    for (size_t order = 0; order < 3; ++order) {
+        set_state_derivative(equations[m], n, order);
+        equations[m].d_parameter[TargetPosition + order] = -1.0;
+        m += 1;
+    }
+
+    // Every section without jerk holds an acceleration limit, or the zero acceleration at a velocity limit
+    for (size_t k = 0; k < n; ++k) {
+        if (j[k] != 0.0) {
+            continue;
+        }
+
+        const double a_tolerance = 1e-8 * std::max(1.0, std::max(std::abs(aMax), std::abs(aMin)));
+        const double v_tolerance = 1e-8 * std::max(1.0, std::max(std::abs(vMax), std::abs(vMin)));
+        if (std::abs(a[k] - aMax) < a_tolerance || std::abs(a[k] - aMin) < a_tolerance) {
+            set_state_derivative(equations[m], k, 2);
+            equations[m].d_parameter[(std::abs(a[k] - aMax) < a_tolerance) ? MaxAcceleration : MinAcceleration] = -1.0;
+            m += 1;
+
+        } else if (std::abs(a[k]) < a_tolerance && (std::abs(v[k] - vMax) < v_tolerance || std::abs(v[k] - vMin) < v_tolerance)) {
+            set_state_derivative(equations[m], k, 2);
+            m += 1;
+
+            set_state_derivative(equations[m], k, 1);
+            equations[m].d_parameter[(std::abs(v[k] - vMax) < v_tolerance) ? MaxVelocity : MinVelocity] = -1.0;
+            m += 1;
+
+        } else {
+            return false;
+        }
+    }
+
+    if (m != n) {
+        return false;
+    }
+
+    // The duration T = sum(t) has the derivative dT = -lambda^T dF/dparameter with (dF/dt)^T lambda = 1
+    std::array<std::array<double, 8>, 7> matrix; // Augmented transposed Jacobian
+    double max_entry {0.0};
+    for (size_t row = 0; row < n; ++row) {
+        for (size_t col = 0; col < n; ++col) {
+            matrix[row][col] = equations[col].d_t[row];
+            max_entry = std::max(max_entry, std::abs(matrix[row][col]));
+        }
+        matrix[row][n] = 1.0;
+    }
+
+    for (size_t col = 0; col < n; ++col) {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < n; ++row) {
+            if (std::abs(matrix[row][col]) > std::abs(matrix[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (std::abs(matrix[pivot][col]) < 1e-10 * max_entry) {
+            return false;
+        }
+        std::swap(matrix[col], matrix[pivot]);
+
+        for (size_t row = col + 1; row < n; ++row) {
+            const double factor = matrix[row][col] / matrix[col][col];
+            for (size_t i = col; i <= n; ++i) {
+                matrix[row][i] -= factor * matrix[col][i];
+            }
+        }
+    }
+
+    std::array<double, 7> lambda;
+    for (size_t row = n; row-- > 0;) {
+        double sum = matrix[row][n];
+        for (size_t col = row + 1; col < n; ++col) {
+            sum -= matrix[row][col] * lambda[col];
+        }
+        lambda[row] = sum / matrix[row][row];
+    }
+
+    std::array<double, NumberOfParameters> result {};
+    for (size_t row = 0; row < n; ++row) {
+        for (size_t i = 0; i < NumberOfParameters; ++i) {
+            result[i] -= lambda[row] * equations[row].d_parameter[i];
+        }
+    }
+
+    target_position = result[TargetPosition];
+    target_velocity = result[TargetVelocity];
+    target_acceleration = result[TargetAcceleration];
+
+    // The brake pre-trajectory and therefore the initial state of the profile depend on the limits as well
+    if (profile.brake.duration > 0.0) {
+        return true;
+    }
+
+    max_velocity = result[MaxVelocity];
+    min_velocity = result[MinVelocity];
+    max_acceleration = result[MaxAcceleration];
+    min_acceleration = result[MinAcceleration];
+    max_jerk = result[MaxJerk];
+    return true;
+}
+
+} // namespace ruckig
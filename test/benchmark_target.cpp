@@ -1,5 +1,16 @@
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstring>
+#include <optional>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "randomizer.hpp"
 
@@ -9,6 +20,54 @@
 using namespace ruckig;
 
 
+//! Counts the L1 instruction cache misses of this process via the Linux perf interface, if available
+class InstructionCacheMissCounter {
+    int fd {-1};
+
+public:
+    explicit InstructionCacheMissCounter() {
+#if defined(__linux__)
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1I | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~InstructionCacheMissCounter() {
+#if defined(__linux__)
+        if (fd >= 0) {
+            close(fd);
+        }
+#endif
+    }
+
+    void start() {
+#if defined(__linux__)
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    std::optional<long long> stop() {
+#if defined(__linux__)
+        long long count;
+        if (fd >= 0 && ioctl(fd, PERF_EVENT_IOC_DISABLE, 0) == 0 && read(fd, &count, sizeof(count)) == sizeof(count)) {
+            return count;
+        }
+#endif
+        return std::nullopt;
+    }
+};
+
+
 template<size_t DOFs, class OTGType>
 double check_update(OTGType& otg, InputParameter<DOFs>& input) {
     OutputParameter<DOFs> output;
@@ -38,11 +97,64 @@ std::tuple<double, double> analyze(const std::vector<double>& v) {
 }
 
 
+//! Print the share of each profile family (reached limits) among the minimal-duration profiles of Step 1 and the final profiles of Step 2
+template<size_t DOFs>
+void print_family_statistics(double number_trajectories) {
+    RuckigThrow<DOFs> otg {0.005};
+
+    std::normal_distribution<double> position_dist {0.0, 4.0};
+    std::normal_distribution<double> dynamic_dist {0.0, 0.8};
+    std::uniform_real_distribution<double> limit_dist {0.1, 12.0};
+
+    Randomizer<DOFs, decltype(position_dist)> p { position_dist, 42 };
+    Randomizer<DOFs, decltype(dynamic_dist)> d { dynamic_dist, 43 };
+    Randomizer<DOFs, decltype(limit_dist)> l { limit_dist, 44 };
+
+    InputParameter<DOFs> input;
+    Trajectory<DOFs> trajectory;
+    std::array<size_t, 8> step1_counts {}, step2_counts {};
+    size_t number_profiles {0};
+    for (size_t i = 0; i < number_trajectories; ++i) {
+        p.fill(input.current_position);
+        d.fill_or_zero(input.current_velocity, 0.9);
+        d.fill_or_zero(input.current_acceleration, 0.8);
+        p.fill(input.target_position);
+        d.fill_or_zero(input.target_velocity, 0.7);
+        d.fill_or_zero(input.target_acceleration, 0.6);
+        l.fill(input.max_velocity, input.target_velocity);
+        l.fill(input.max_acceleration, input.target_acceleration);
+        l.fill(input.max_jerk);
+
+        if (!otg.template validate_input<false>(input) || otg.calculate(input, trajectory) != Result::Working) {
+            continue;
+        }
+
+        const auto& blocks = otg.get_blocks();
+        const auto profiles = trajectory.get_profiles();
+        for (size_t dof = 0; dof < DOFs; ++dof) {
+            step1_counts[static_cast<size_t>(blocks[dof].p_min.limits)] += 1;
+            step2_counts[static_cast<size_t>(profiles[0][dof].limits)] += 1;
+        }
+        number_profiles += DOFs;
+    }
+
+    const std::array<std::string, 8> names {"ACC0_ACC1_VEL", "VEL", "ACC0", "ACC1", "ACC0_ACC1", "ACC0_VEL", "ACC1_VEL", "NONE"};
+    std::cout << "---" << std::endl;
+    std::cout << "Profile Families of " << number_profiles << " Profiles (Step 1 / Step 2) [%]" << std::endl;
+    for (size_t family = 0; family < names.size(); ++family) {
+        std::cout << names[family] << " " << 100.0 * step1_counts[family] / number_profiles << " / " << 100.0 * step2_counts[family] / number_profiles << std::endl;
+    }
+}
+
+
 template<size_t DOFs, class OTGType>
-void benchmark(size_t n, double number_trajectories, bool verbose = true) {
+void benchmark(size_t n, double number_trajectories, bool verbose = true, bool equal_dofs = false, bool deduplicate_dofs = false, double enabled_fraction = 1.0, bool adaptive_family_order = false, double position_scale = 1.0) {
     OTGType otg {0.005};
+    otg.calculator.target_calculator.deduplicate_dofs = deduplicate_dofs;
+    otg.calculator.target_calculator.adaptive_family_order = adaptive_family_order;
 
-    std::normal_distribution<double> position_dist {0.0, 4.0};
+    // Scale the positions for skewed workloads, e.g. long moves mostly reach all limits while short corrections reach none
+    std::normal_distribution<double> position_dist {0.0, 4.0 * position_scale};
     std::normal_distribution<double> dynamic_dist {0.0, 0.8};
     std::uniform_real_distribution<double> limit_dist {0.1, 12.0};
 
@@ -51,9 +163,13 @@ void benchmark(size_t n, double number_trajectories, bool verbose = true) {
     Randomizer<DOFs, decltype(limit_dist)> l { limit_dist, 44 };
 
     InputParameter<DOFs> input;
+    for (size_t dof = 0; dof < DOFs; ++dof) {
+        input.enabled[dof] = std::floor((dof + 1) * enabled_fraction) > std::floor(dof * enabled_fraction); // Spread evenly
+    }
     // input.synchronization = Synchronization::None;
     // input.control_interface = ControlInterface::Velocity;
-    std::vector<double> average, worst, global;
+    std::vector<double> average, worst, global, cache_misses;
+    InstructionCacheMissCounter cache_miss_counter;
 
     // Initial warm-up calculation
     // p.fill(input.current_position);
@@ -69,6 +185,7 @@ void benchmark(size_t n, double number_trajectories, bool verbose = true) {
         size_t n {1};
 
         const auto start = std::chrono::steady_clock::now();
+        cache_miss_counter.start();
 
         for (size_t i = 0; i < number_trajectories; ++i) {
             p.fill(input.current_position);
@@ -84,6 +201,23 @@ void benchmark(size_t n, double number_trajectories, bool verbose = true) {
             l.fill(input.max_acceleration, input.target_acceleration);
             l.fill(input.max_jerk);
 
+            // The second half of the DoFs equals (or mirrors) the first half, e.g. for tandem axes or mirrored gripper fingers
+            if (equal_dofs) {
+                for (size_t dof = DOFs / 2; dof < DOFs; ++dof) {
+                    const size_t other = dof - DOFs / 2;
+                    const double sign = (other % 2 == 0) ? 1.0 : -1.0;
+                    input.current_position[dof] = sign * input.current_position[other];
+                    input.current_velocity[dof] = sign * input.current_velocity[other];
+                    input.current_acceleration[dof] = sign * input.current_acceleration[other];
+                    input.target_position[dof] = sign * input.target_position[other];
+                    input.target_velocity[dof] = sign * input.target_velocity[other];
+                    input.target_acceleration[dof] = sign * input.target_acceleration[other];
+                    input.max_velocity[dof] = input.max_velocity[other];
+                    input.max_acceleration[dof] = input.max_acceleration[other];
+                    input.max_jerk[dof] = input.max_jerk[other];
+                }
+            }
+
             // input.current_velocity[0] = 0.5;
             // input.target_velocity[0] = 0.5;
             // input.target_position[0] = input.current_position[0] + 1.0;
@@ -101,12 +235,16 @@ void benchmark(size_t n, double number_trajectories, bool verbose = true) {
             ++n;
         }
 
+        const auto cache_misses_ = cache_miss_counter.stop();
         const auto stop = std::chrono::steady_clock::now();
         const double global_ = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count() / 1000.0 / number_trajectories;
 
         average.emplace_back(average_);
         worst.emplace_back(worst_);
         global.emplace_back(global_);
+        if (cache_misses_) {
+            cache_misses.emplace_back(static_cast<double>(*cache_misses_) / number_trajectories);
+        }
     }
 
     const auto [average_mean, average_std] = analyze(average);
@@ -115,10 +253,40 @@ void benchmark(size_t n, double number_trajectories, bool verbose = true) {
 
     if (verbose) {
         std::cout << "---" << std::endl;
-        std::cout << "Benchmark for " << otg.degrees_of_freedom << " DoFs on " << number_trajectories << " trajectories" << std::endl;
+        std::cout << "Benchmark for " << otg.degrees_of_freedom << " DoFs on " << number_trajectories << " trajectories";
+        if (equal_dofs) {
+            std::cout << " with equal DoFs";
+        }
+        if (deduplicate_dofs) {
+            std::cout << " with deduplication";
+        }
+        if (enabled_fraction < 1.0) {
+            std::cout << " with " << enabled_fraction * 100 << "% enabled DoFs";
+        }
+        if (position_scale != 1.0) {
+            std::cout << " with position scale " << position_scale;
+        }
+        if (adaptive_family_order) {
+            std::cout << " with adaptive family order";
+        }
+        std::cout << std::endl;
         std::cout << "Average Calculation Duration " << average_mean << " pm " << average_std << " [µs]" << std::endl;
         std::cout << "Worst Calculation Duration " << worst_mean << " pm " << worst_std << " [µs]" << std::endl;
         std::cout << "End-to-end Calculation Duration " << global_mean << " pm " << global_std << " [µs]" << std::endl;
+        if (!cache_misses.empty()) {
+            const auto [cache_misses_mean, cache_misses_std] = analyze(cache_misses);
+            std::cout << "L1 Instruction Cache Misses " << cache_misses_mean << " pm " << cache_misses_std << " [per trajectory]" << std::endl;
+        } else {
+            std::cout << "L1 Instruction Cache Misses not available" << std::endl;
+        }
+        if (adaptive_family_order) {
+            const auto& statistics = otg.calculator.target_calculator.family_statistics;
+            std::cout << "Step 2 Family Order (Successes)";
+            for (const size_t family: statistics.step2_order) {
+                std::cout << " " << family << " (" << statistics.step2_hits[family] << ")";
+            }
+            std::cout << std::endl;
+        }
     }
 
     // std::cout << otg.degrees_of_freedom << "\t" << average_mean << "\t" << average_std << "\t" << worst_mean << "\t" << worst_std << std::endl;
@@ -134,4 +302,12 @@ int main() {
 
     const size_t DOFs {3};
     benchmark<DOFs, RuckigThrow<DOFs>>(n, number_trajectories);
+    print_family_statistics<DOFs>(number_trajectories);
+
+    // benchmark<6, Ruckig<6>>(n, number_trajectories, true, true, true);
+    // benchmark<6, Ruckig<6>>(n, number_trajectories, true, true, false);
+
+    // for (const double enabled_fraction: {0.125, 0.25, 0.5, 1.0}) {
+    //     benchmark<48, Ruckig<48>>(n, number_trajectories / 8, true, false, true, enabled_fraction);
+    // }
 }
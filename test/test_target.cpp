@@ -1,11 +1,16 @@
 #define DOCTEST_CONFIG_IMPLEMENT
 #include <doctest/doctest.h>
 
+#include <cstring>
 #include <deque>
+#include <fstream>
 #include <random>
 #include <optional>
 #include "randomizer.hpp"
 
+#include <ruckig/coordinator.hpp>
+#include <ruckig/duration_grid.hpp>
+#include <ruckig/trajectory_buffer.hpp>
 #include <ruckig/error.hpp>
 #include <ruckig/ruckig.hpp>
 
@@ -435,6 +440,47 @@ TEST_CASE("input-validation") {
     CHECK_FALSE( otg.validate_input<false>(input) );
 }
 
+TEST_CASE("input-validation-order") {
+    RuckigThrow<2> otg;
+    InputParameter<2> input;
+
+    const double nan = std::nan("");
+
+    input.current_position = {0.0, 0.0};
+    input.target_position = {1.0, 1.0};
+    input.max_velocity = {1.0, 1.0};
+    input.max_acceleration = {1.0, 1.0};
+    input.max_jerk = {1.0, 1.0};
+
+    // Per DoF, the states are checked for valid numbers before the velocity limits
+    input.target_acceleration = {0.0, nan};
+    input.max_velocity = {1.0, -1.0};
+    CHECK_THROWS_WITH_AS( otg.validate_input(input), doctest::Contains("target acceleration"), RuckigError);
+
+    input.target_acceleration = {0.0, 0.0};
+    input.current_position = {0.0, nan};
+    CHECK_THROWS_WITH_AS( otg.validate_input(input), doctest::Contains("current position"), RuckigError);
+
+    // The current state is checked before the target state for each kind of check
+    input.current_position = {0.0, 0.0};
+    input.max_velocity = {1.0, 1.0};
+    input.current_velocity = {0.0, 2.0};
+    input.target_velocity = {0.0, nan};
+    CHECK_THROWS_WITH_AS( otg.validate_input(input, true, true), doctest::Contains("target velocity"), RuckigError);
+
+    input.target_velocity = {0.0, 0.0};
+    input.current_acceleration = {0.0, 0.5};
+    input.target_acceleration = {0.0, 2.0};
+    CHECK_THROWS_WITH_AS( otg.validate_input(input, true, true), doctest::Contains("target acceleration 2.000000 of DoF 1 exceeds"), RuckigError);
+
+    // Earlier DoFs are checked completely before later DoFs
+    input.current_acceleration = {0.0, 0.0};
+    input.target_acceleration = {0.0, 0.0};
+    input.current_velocity = {2.0, 0.0};
+    input.max_jerk = {1.0, -1.0};
+    CHECK_THROWS_WITH_AS( otg.validate_input(input, true, true), doctest::Contains("current velocity 2.000000 of DoF 0"), RuckigError);
+}
+
 TEST_CASE("enabled") {
     RuckigThrow<3> otg {0.005};
     InputParameter<3> input;
@@ -483,6 +529,16 @@ TEST_CASE("enabled") {
     result = otg.update(input, output);
     CHECK( result == Result::Working );
     CHECK( output.trajectory.get_duration() == doctest::Approx(3.6578610221) );
+
+    // Without any enabled DoF, the trajectory keeps the current state
+    Trajectory<3> trajectory;
+    input.enabled = {false, false, false};
+    CHECK( otg.calculate(input, trajectory) == Result::Working );
+    CHECK( trajectory.get_duration() == 0.0 );
+
+    trajectory.at_time(0.0, new_position, new_velocity, new_acceleration);
+    CHECK( array_eq(new_position, input.current_position) );
+    CHECK( array_eq(new_velocity, input.current_velocity) );
 }
 
 TEST_CASE("phase-synchronization") {
@@ -928,6 +984,1365 @@ TEST_CASE("custom-vector-type") {
     }
 }
 
+TEST_CASE("scalar-type") {
+    std::default_random_engine gen (seed);
+    std::uniform_real_distribution<double> root_dist {0.5, 5.0};
+
+    for (size_t i = 0; i < 4096; ++i) {
+        std::array<double, 4> r;
+        for (auto& ri: r) {
+            ri = root_dist(gen);
+        }
+        std::sort(r.begin(), r.end());
+        if (r[1] - r[0] < 0.5 || r[2] - r[1] < 0.5 || r[3] - r[2] < 0.5) {
+            continue;
+        }
+
+        // Expand (x - r0)(x - r1)(x - r2)(x - r3) into the monic polynomial
+        const std::array<double, 4> polynom {
+            -(r[0] + r[1] + r[2] + r[3]),
+            r[0]*r[1] + r[0]*r[2] + r[0]*r[3] + r[1]*r[2] + r[1]*r[3] + r[2]*r[3],
+            -(r[0]*r[1]*r[2] + r[0]*r[1]*r[3] + r[0]*r[2]*r[3] + r[1]*r[2]*r[3]),
+            r[0]*r[1]*r[2]*r[3],
+        };
+        const std::array<float, 4> polynom_float {(float)polynom[0], (float)polynom[1], (float)polynom[2], (float)polynom[3]};
+
+        auto roots_double = roots::solve_quart_monic(polynom);
+        auto roots_float = roots::solve_quart_monic(polynom_float);
+
+        std::vector<double> values_double (roots_double.begin(), roots_double.end());
+        std::vector<float> values_float (roots_float.begin(), roots_float.end());
+        REQUIRE( values_double.size() == 4 );
+        REQUIRE( values_float.size() == 4 );
+        for (size_t j = 0; j < 4; ++j) {
+            CHECK( values_double[j] == doctest::Approx(r[j]).epsilon(1e-6) );
+            CHECK( values_float[j] == doctest::Approx(r[j]).epsilon(1e-2) );
+
+            // Polish the single-precision root in double precision
+            const std::array<double, 5> polynom_full {1.0, polynom[0], polynom[1], polynom[2], polynom[3]};
+            const double polished = roots::shrink_interval(polynom_full, values_float[j] - 0.2, values_float[j] + 0.2);
+            CHECK( polished == doctest::Approx(r[j]).epsilon(1e-9) );
+        }
+
+        const std::array<double, 3> cubic {-(r[0] + r[1] + r[2]), r[0]*r[1] + r[0]*r[2] + r[1]*r[2], -r[0]*r[1]*r[2]};
+        auto cubic_double = roots::solve_cubic(1.0, cubic[0], cubic[1], cubic[2]);
+        auto cubic_float = roots::solve_cubic(1.0f, (float)cubic[0], (float)cubic[1], (float)cubic[2]);
+        std::vector<double> cubic_values_double (cubic_double.begin(), cubic_double.end());
+        std::vector<float> cubic_values_float (cubic_float.begin(), cubic_float.end());
+        REQUIRE( cubic_values_double.size() == 3 );
+        REQUIRE( cubic_values_float.size() == 3 );
+        for (size_t j = 0; j < 3; ++j) {
+            CHECK( cubic_values_double[j] == doctest::Approx(r[j]).epsilon(1e-6) );
+            CHECK( cubic_values_float[j] == doctest::Approx(r[j]).epsilon(1e-2) );
+        }
+    }
+
+    // Mixed argument types resolve to the double precision overloads
+    auto cubic_mixed = roots::solve_cubic(1, -6.0, 11.0, -6);
+    std::vector<double> cubic_mixed_values (cubic_mixed.begin(), cubic_mixed.end());
+    REQUIRE( cubic_mixed_values.size() == 3 );
+    CHECK( cubic_mixed_values[0] == doctest::Approx(1.0) );
+    CHECK( cubic_mixed_values[2] == doctest::Approx(3.0) );
+
+    auto quart_mixed = roots::solve_quart_monic(-10.0, 35, -50.0, 24);
+    CHECK( std::vector<double>(quart_mixed.begin(), quart_mixed.end()).size() == 4 );
+
+    const std::array<double, 3> quadratic {1.0, -3.0, 2.0};
+    CHECK( roots::poly_eval(quadratic, 2) == 0.0 );
+    CHECK( roots::shrink_interval(quadratic, 1.5, 3) == doctest::Approx(2.0) );
+}
+
+TEST_CASE("step1-cache") {
+    const size_t DOFs = 3;
+    RuckigThrow<DOFs> otg {0.005};
+    RuckigThrow<DOFs> otg_cached {0.005};
+    otg_cached.calculator.target_calculator.step1_cache.resize(16);
+    InputParameter<DOFs> input;
+    OutputParameter<DOFs> output, output_cached;
+
+    Randomizer<DOFs, decltype(position_dist)> p { position_dist, seed + 9 };
+    Randomizer<DOFs, decltype(dynamic_dist)> d { dynamic_dist, seed + 10 };
+    Randomizer<DOFs, decltype(limit_dist)> l { limit_dist, seed + 11 };
+
+    // Cycle through a few inputs repeatedly, so that most Step 1 calculations are served from the cache
+    std::vector<InputParameter<DOFs>> inputs;
+    while (inputs.size() < 4) {
+        p.fill(input.current_position);
+        d.fill_or_zero(input.current_velocity, 0.9);
+        d.fill_or_zero(input.current_acceleration, 0.8);
+        p.fill(input.target_position);
+        d.fill_or_zero(input.target_velocity, 0.7);
+        d.fill_or_zero(input.target_acceleration, 0.6);
+        l.fill(input.max_velocity, input.target_velocity);
+        l.fill(input.max_acceleration, input.target_acceleration);
+        l.fill(input.max_jerk);
+
+        if (otg.validate_input<false>(input)) {
+            inputs.push_back(input);
+        }
+    }
+
+    for (size_t i = 0; i < 64; ++i) {
+        const auto& current_input = inputs[i % inputs.size()];
+        const Result result = otg.calculate(current_input, output.trajectory);
+        const Result result_cached = otg_cached.calculate(current_input, output_cached.trajectory);
+        CHECK( result == result_cached );
+        CHECK( output_cached.trajectory.get_duration() == output.trajectory.get_duration() );
+
+        double time {0.0};
+        while (time < output.trajectory.get_duration()) {
+            output.trajectory.at_time(time, output.new_position, output.new_velocity, output.new_acceleration);
+            output_cached.trajectory.at_time(time, output_cached.new_position, output_cached.new_velocity, output_cached.new_acceleration);
+            CHECK( output_cached.new_position == output.new_position );
+            CHECK( output_cached.new_velocity == output.new_velocity );
+            CHECK( output_cached.new_acceleration == output.new_acceleration );
+            time += 0.1;
+        }
+    }
+
+    const auto& cache = otg_cached.calculator.target_calculator.step1_cache;
+    CHECK( cache.hits + cache.misses == 64 * DOFs );
+    CHECK( cache.hit_rate() > 0.5 );
+
+    otg_cached.calculator.target_calculator.step1_cache.resize(0);
+    CHECK( otg_cached.calculate(inputs[0], output_cached.trajectory) == Result::Working );
+    CHECK( cache.hits + cache.misses == 0 );
+}
+
+TEST_CASE("normalized-step1") {
+    const size_t DOFs = 3;
+    RuckigThrow<DOFs> otg {0.005};
+    RuckigThrow<DOFs> otg_normalized {0.005};
+    RuckigThrow<DOFs> otg_scaled {0.005};
+
+    BlockCache shared_cache {64};
+    otg_normalized.calculator.target_calculator.normalize_step1 = true;
+    otg_normalized.calculator.target_calculator.normalized_step1_cache = &shared_cache;
+    otg_scaled.calculator.target_calculator.normalize_step1 = true;
+    otg_scaled.calculator.target_calculator.normalized_step1_cache = &shared_cache;
+
+    InputParameter<DOFs> input, input_scaled;
+    Trajectory<DOFs> trajectory, trajectory_normalized, trajectory_scaled;
+
+    Randomizer<DOFs, decltype(position_dist)> p { position_dist, seed + 12 };
+    Randomizer<DOFs, decltype(dynamic_dist)> d { dynamic_dist, seed + 13 };
+    Randomizer<DOFs, decltype(limit_dist_high)> l { limit_dist_high, seed + 14 };
+
+    size_t number_scaled_hits {0}, number_scaled_lookups {0};
+    for (size_t i = 0; i < 1024; ++i) {
+        p.fill(input.current_position);
+        d.fill_or_zero(input.current_velocity, 0.9);
+        d.fill_or_zero(input.current_acceleration, 0.8);
+        p.fill(input.target_position);
+        d.fill_or_zero(input.target_velocity, 0.7);
+        d.fill_or_zero(input.target_acceleration, 0.6);
+        l.fill(input.max_velocity, input.target_velocity);
+        l.fill(input.max_acceleration, input.target_acceleration);
+        l.fill(input.max_jerk);
+
+        if (!otg.validate_input<false>(input)) {
+            --i;
+            continue;
+        }
+
+        CAPTURE( input );
+
+        const Result result = otg.calculate(input, trajectory);
+        const Result result_normalized = otg_normalized.calculate(input, trajectory_normalized);
+        CHECK( result == result_normalized );
+        if (result != Result::Working) {
+            continue;
+        }
+
+        CHECK( trajectory_normalized.get_duration() == doctest::Approx(trajectory.get_duration()) );
+        check_calculation(otg_normalized, input);
+
+        // Doubling all kinematic values and limits keeps the time scale, and maps to the same (cached) normalized problem
+        const size_t hits_before = shared_cache.hits;
+        input_scaled = input;
+        for (size_t dof = 0; dof < DOFs; ++dof) {
+            input_scaled.current_position[dof] *= 2;
+            input_scaled.current_velocity[dof] *= 2;
+            input_scaled.current_acceleration[dof] *= 2;
+            input_scaled.target_position[dof] *= 2;
+            input_scaled.target_velocity[dof] *= 2;
+            input_scaled.target_acceleration[dof] *= 2;
+            input_scaled.max_velocity[dof] *= 2;
+            input_scaled.max_acceleration[dof] *= 2;
+            input_scaled.max_jerk[dof] *= 2;
+        }
+
+        CHECK( otg_scaled.calculate(input_scaled, trajectory_scaled) == Result::Working );
+        CHECK( trajectory_scaled.get_duration() == doctest::Approx(trajectory.get_duration()) );
+        number_scaled_hits += shared_cache.hits - hits_before;
+        number_scaled_lookups += DOFs;
+    }
+
+    // Some lookups miss due to collisions in the direct-mapped cache
+    CHECK( number_scaled_hits > number_scaled_lookups * 9 / 10 );
+}
+
+TEST_CASE("fan-out") {
+    const size_t DOFs = 3;
+    RuckigThrow<DOFs> otg {0.005};
+    InputParameter<DOFs> input;
+    Trajectory<DOFs> trajectory;
+
+    Randomizer<DOFs, decltype(position_dist)> p { position_dist, seed + 15 };
+    Randomizer<DOFs, decltype(dynamic_dist)> d { dynamic_dist, seed + 16 };
+    Randomizer<DOFs, decltype(limit_dist)> l { limit_dist, seed + 17 };
+
+    for (size_t i = 0; i < 16; ++i) {
+        input.synchronization = (i % 2 == 0) ? Synchronization::Time : Synchronization::Phase;
+
+        p.fill(input.current_position);
+        d.fill_or_zero(input.current_velocity, 0.9);
+        d.fill_or_zero(input.current_acceleration, 0.8);
+        l.fill(input.max_velocity);
+        l.fill(input.max_acceleration);
+        l.fill(input.max_jerk);
+
+        std::vector<KinematicState<DOFs>> targets (64);
+        for (auto& target: targets) {
+            p.fill(target.position);
+            d.fill_or_zero(target.velocity, 0.7);
+            d.fill_or_zero(target.acceleration, 0.6);
+        }
+
+        std::vector<Trajectory<DOFs>> trajectories;
+        std::vector<double> durations, durations_parallel;
+        std::vector<Result> results, results_durations, results_parallel;
+        otg.calculate(input, targets, trajectories, results);
+        otg.calculate_durations(input, targets, durations, results_durations);
+        otg.calculate_durations(input, targets, durations_parallel, results_parallel, 4);
+
+        REQUIRE( trajectories.size() == targets.size() );
+        for (size_t j = 0; j < targets.size(); ++j) {
+            input.target_position = targets[j].position;
+            input.target_velocity = targets[j].velocity;
+            input.target_acceleration = targets[j].acceleration;
+            CAPTURE( input );
+
+            const bool is_valid = otg.validate_input<false>(input, false, true);
+            CHECK( (results[j] == Result::Working) == is_valid );
+            CHECK( results_durations[j] == results[j] );
+            CHECK( results_parallel[j] == results[j] );
+            if (!is_valid) {
+                CHECK( std::isinf(durations[j]) );
+                continue;
+            }
+
+            CHECK( otg.calculate(input, trajectory) == Result::Working );
+            CHECK( trajectories[j].get_duration() == trajectory.get_duration() );
+            CHECK( durations[j] == trajectory.get_duration() );
+            CHECK( durations_parallel[j] == trajectory.get_duration() );
+
+            std::array<double, DOFs> new_position, new_position_fan_out, new_velocity, new_acceleration;
+            trajectory.at_time(trajectory.get_duration() / 2, new_position, new_velocity, new_acceleration);
+            trajectories[j].at_time(trajectory.get_duration() / 2, new_position_fan_out, new_velocity, new_acceleration);
+            CHECK( new_position_fan_out == new_position );
+        }
+    }
+
+    // Invalid limits are reported once for all targets
+    input.max_jerk[0] = -1.0;
+    std::vector<KinematicState<DOFs>> targets (2);
+    std::vector<double> durations;
+    std::vector<Result> results;
+    CHECK_THROWS_AS( otg.calculate_durations(input, targets, durations, results), RuckigError );
+}
+
+TEST_CASE("fan-in") {
+    const size_t DOFs = 3;
+    RuckigThrow<DOFs> otg {0.005};
+    InputParameter<DOFs> input;
+    Trajectory<DOFs> trajectory;
+
+    Randomizer<DOFs, decltype(position_dist)> p { position_dist, seed + 18 };
+    Randomizer<DOFs, decltype(dynamic_dist)> d { dynamic_dist, seed + 19 };
+    Randomizer<DOFs, decltype(limit_dist)> l { limit_dist, seed + 20 };
+
+    for (size_t i = 0; i < 16; ++i) {
+        input.duration_discretization = (i % 4 == 0) ? DurationDiscretization::Discrete : DurationDiscretization::Continuous;
+
+        p.fill(input.target_position);
+        d.fill_or_zero(input.target_velocity, 0.7);
+        d.fill_or_zero(input.target_acceleration, 0.6);
+        l.fill(input.max_velocity, input.target_velocity);
+        l.fill(input.max_acceleration, input.target_acceleration);
+        l.fill(input.max_jerk);
+        if (!input.validate<false>()) {
+            --i;
+            continue;
+        }
+
+        std::vector<KinematicState<DOFs>> current_states (64);
+        for (auto& current_state: current_states) {
+            p.fill(current_state.position);
+            d.fill_or_zero(current_state.velocity, 0.9);
+            d.fill_or_zero(current_state.acceleration, 0.8);
+        }
+        current_states[0].position[0] = std::numeric_limits<double>::quiet_NaN();
+
+        std::vector<Trajectory<DOFs>> trajectories;
+        std::vector<double> durations;
+        std::vector<Result> results, results_durations;
+        otg.calculate_from_current_states(input, current_states, trajectories, results);
+        otg.calculate_durations_from_current_states(input, current_states, durations, results_durations, 2);
+
+        CHECK( results[0] == Result::ErrorInvalidInput );
+        CHECK( std::isinf(durations[0]) );
+        for (size_t j = 1; j < current_states.size(); ++j) {
+            input.current_position = current_states[j].position;
+            input.current_velocity = current_states[j].velocity;
+            input.current_acceleration = current_states[j].acceleration;
+            CAPTURE( input );
+
+            CHECK( otg.calculate(input, trajectory) == results[j] );
+            CHECK( results_durations[j] == results[j] );
+            if (results[j] != Result::Working) {
+                continue;
+            }
+
+            CHECK( trajectories[j].get_duration() == trajectory.get_duration() );
+            CHECK( durations[j] == trajectory.get_duration() );
+        }
+    }
+
+    // An invalid target is reported once for all current states
+    input.target_acceleration[0] = 2 * input.max_acceleration[0];
+    std::vector<KinematicState<DOFs>> current_states (2);
+    std::vector<double> durations;
+    std::vector<Result> results;
+    CHECK_THROWS_AS( otg.calculate_durations_from_current_states(input, current_states, durations, results), RuckigError );
+}
+
+TEST_CASE("duration-grid") {
+    const size_t DOFs = 2;
+    RuckigThrow<DOFs> otg;
+    Trajectory<DOFs> trajectory;
+
+    InputParameter<DOFs> input;
+    input.current_position = {0.0, 0.0};
+    input.current_velocity = {0.2, -0.1};
+    input.target_position = {1.0, 0.5};
+    input.target_velocity = {0.0, 0.1};
+    input.max_velocity = {1.0, 1.0};
+    input.max_acceleration = {1.0, 2.0};
+    input.max_jerk = {2.0, 2.0};
+
+    DurationGrid<DOFs> grid {{
+        {GridQuantity::TargetPosition, 0, -2.0, 2.0, 9},
+        {GridQuantity::MaxVelocity, 1, 0.5, 1.5, 5},
+        {GridQuantity::TargetVelocity, 0, -0.8, 0.8, 5},
+    }};
+    grid.calculate(input, 3);
+    REQUIRE( grid.durations.size() == 9 * 5 * 5 );
+
+    for (size_t i = 0; i < 9; ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+            for (size_t k = 0; k < 5; ++k) {
+                input.target_position[0] = grid.axes[0].at(i);
+                input.max_velocity[1] = grid.axes[1].at(j);
+                input.target_velocity[0] = grid.axes[2].at(k);
+                CAPTURE( input );
+
+                const double duration = grid.durations[(i * 5 + j) * 5 + k];
+                if (!otg.validate_input<false>(input)) {
+                    CHECK( std::isinf(duration) );
+                    continue;
+                }
+
+                CHECK( otg.calculate(input, trajectory) == Result::Working );
+                CHECK( duration == trajectory.get_duration() );
+                CHECK( grid.at(std::array<double, 3> {input.target_position[0], input.max_velocity[1], input.target_velocity[0]}) == doctest::Approx(duration) );
+            }
+        }
+    }
+
+    // Interpolation between grid points and clamping outside of the grid
+    const double d0 = grid.durations[(4 * 5 + 2) * 5 + 2], d1 = grid.durations[(5 * 5 + 2) * 5 + 2];
+    CHECK( grid.at(std::array<double, 3> {0.125, 1.0, 0.0}) == doctest::Approx((d0 + d1) / 2) );
+    CHECK( grid.at(std::array<double, 3> {-5.0, 1.0, 0.0}) == doctest::Approx(grid.durations[(0 * 5 + 2) * 5 + 2]) );
+    CHECK( grid.at(std::array<double, 3> {2.0, 1.5, 0.8}) == grid.durations.back() );
+
+    const DurationGrid<DOFs> uncalculated_grid {grid.axes};
+    CHECK( std::isnan(uncalculated_grid.at(std::array<double, 3> {0.125, 1.0, 0.0})) );
+
+    const std::string filename {"duration_grid_test.bin"};
+    REQUIRE( grid.save(filename) );
+    DurationGrid<DOFs> loaded_grid;
+    REQUIRE( loaded_grid.load(filename) );
+    DurationGrid<DynamicDOFs> loaded_dynamic_grid;
+    CHECK( loaded_dynamic_grid.load(filename, 2) );
+    CHECK( loaded_dynamic_grid.durations == grid.durations );
+    std::remove(filename.c_str());
+
+    REQUIRE( loaded_grid.axes.size() == 3 );
+    CHECK( loaded_grid.axes[1].quantity == GridQuantity::MaxVelocity );
+    CHECK( loaded_grid.axes[1].dof == 1 );
+    CHECK( loaded_grid.axes[2].count == 5 );
+    CHECK( loaded_grid.durations == grid.durations );
+
+    // Reject truncated or corrupt files without changing the grid
+    REQUIRE( grid.save(filename) );
+    std::ifstream saved_file (filename, std::ios::binary);
+    const std::string content {std::istreambuf_iterator<char>(saved_file), std::istreambuf_iterator<char>()};
+    saved_file.close();
+
+    auto load_modified = [&](const std::string& modified_content, size_t degrees_of_freedom = 2) {
+        std::ofstream(filename, std::ios::binary) << modified_content;
+        const bool result = loaded_grid.load(filename, degrees_of_freedom);
+        std::remove(filename.c_str());
+        return result;
+    };
+
+    const size_t axes_offset {8 + 4 + 4 + 8}, axis_size {5 * 8};
+    auto with_value = [&](size_t offset, uint64_t value) {
+        std::string modified_content = content;
+        std::memcpy(&modified_content[offset], &value, sizeof(value));
+        return modified_content;
+    };
+
+    CHECK( load_modified(content) );
+    CHECK_FALSE( load_modified(content.substr(0, content.size() - 8)) );
+    CHECK_FALSE( load_modified(content.substr(0, axes_offset + axis_size / 2)) );
+    CHECK_FALSE( load_modified(content + std::string(8, '\0')) );
+    CHECK_FALSE( load_modified(content, 1) ); // Axis of DoF 1
+    CHECK_FALSE( load_modified(with_value(axes_offset - 8, 1000000)) ); // Number of axes
+    CHECK_FALSE( load_modified(with_value(axes_offset + 8, 7)) ); // DoF of first axis
+    CHECK_FALSE( load_modified(with_value(axes_offset + 4 * 8, uint64_t(1) << 62)) ); // Count of first axis
+    CHECK_FALSE( load_modified(with_value(axes_offset + 4 * 8, 0)) );
+
+    std::string swapped_content = content;
+    std::reverse(swapped_content.begin() + 12, swapped_content.begin() + 16); // Byte order of another machine
+    CHECK_FALSE( load_modified(swapped_content) );
+
+    CHECK( loaded_grid.durations == grid.durations );
+
+    grid.axes[0].dof = 2;
+    CHECK_THROWS_AS( grid.calculate(input), RuckigError );
+}
+
+// Integrate a profile with known durations and jerks into a compile-time table
+template<size_t N>
+constexpr std::array<std::array<double, 3>, N + 1> integrate_profile(const std::array<double, N>& t, const std::array<double, N>& j, double p0, double v0, double a0) {
+    std::array<std::array<double, 3>, N + 1> states {};
+    states[0] = {p0, v0, a0};
+    for (size_t i = 0; i < N; ++i) {
+        const auto [p, v, a] = integrate(t[i], states[i][0], states[i][1], states[i][2], j[i]);
+        states[i + 1] = {p, v, a};
+    }
+    return states;
+}
+
+TEST_CASE("constexpr") {
+    constexpr std::array<double, 7> t {1.0, 0.0, 1.0, 0.0, 1.0, 0.0, 1.0};
+    constexpr std::array<double, 7> j {1.0, 0.0, -1.0, 0.0, -1.0, 0.0, 1.0};
+    constexpr auto states = integrate_profile(t, j, 0.0, 0.0, 0.0);
+    static_assert( states[3][1] == 1.0 && states[3][2] == 0.0 );
+    static_assert( states[7][1] == 0.0 && states[7][2] == 0.0 );
+
+    constexpr std::array<double, 4> polynom {1.0, -6.0, 11.0, -6.0};
+    static_assert( roots::poly_eval(polynom, 1.0) == 0.0 && roots::poly_eval(polynom, 3.0) == 0.0 );
+    static_assert( roots::poly_derivative(polynom)[1] == -12.0 );
+
+    // The compile-time table matches the runtime trajectory of the same rest-to-rest motion
+    RuckigThrow<1> otg;
+    InputParameter<1> input;
+    input.current_position = {0.0};
+    input.target_position = {states[7][0]};
+    input.max_velocity = {1.0};
+    input.max_acceleration = {1.0};
+    input.max_jerk = {1.0};
+
+    Trajectory<1> trajectory;
+    otg.calculate(input, trajectory);
+    CHECK( trajectory.get_duration() == doctest::Approx(4.0) );
+
+    double time {0.0};
+    for (size_t i = 0; i < t.size(); ++i) {
+        time += t[i];
+
+        std::array<double, 1> new_position, new_velocity, new_acceleration;
+        trajectory.at_time(time, new_position, new_velocity, new_acceleration);
+        CHECK( new_position[0] == doctest::Approx(states[i + 1][0]) );
+        CHECK( new_velocity[0] == doctest::Approx(states[i + 1][1]) );
+        CHECK( new_acceleration[0] == doctest::Approx(states[i + 1][2]) );
+    }
+}
+
+TEST_CASE("duration-sensitivity") {
+    const size_t DOFs = 3;
+    RuckigThrow<DOFs> otg {0.005};
+    RuckigThrow<DOFs> otg_sensitivity {0.005};
+    otg_sensitivity.calculator.target_calculator.calculate_duration_sensitivities = true;
+
+    InputParameter<DOFs> input, input_perturbed;
+    Trajectory<DOFs> trajectory, trajectory_perturbed;
+
+    Randomizer<DOFs, decltype(position_dist)> p { position_dist, seed + 21 };
+    Randomizer<DOFs, decltype(dynamic_dist)> d { dynamic_dist, seed + 22 };
+    Randomizer<DOFs, decltype(limit_dist)> l { limit_dist, seed + 23 };
+
+    // Duration of the synchronized trajectory or of a single independent DoF
+    auto duration = [&](const InputParameter<DOFs>& inp, std::optional<size_t> dof) {
+        otg.calculate(inp, trajectory_perturbed);
+        return dof ? trajectory_perturbed.get_independent_min_durations()[dof.value()] : trajectory_perturbed.get_duration();
+    };
+
+    auto perturb = [](InputParameter<DOFs>& inp, size_t dof, size_t parameter, double delta) {
+        switch (parameter) {
+            case 0: inp.target_position[dof] += delta; break;
+            case 1: inp.target_velocity[dof] += delta; break;
+            case 2: inp.target_acceleration[dof] += delta; break;
+            case 3: inp.max_velocity[dof] += delta; break;
+            case 4: inp.max_acceleration[dof] += delta; break;
+            case 5: inp.max_jerk[dof] += delta; break;
+        }
+    };
+
+    auto analytic = [](const DurationSensitivity& sensitivity, size_t parameter) {
+        const std::array<double, 6> values {sensitivity.target_position, sensitivity.target_velocity, sensitivity.target_acceleration, sensitivity.max_velocity, sensitivity.max_acceleration, sensitivity.max_jerk};
+        return values[parameter];
+    };
+
+    size_t number_checked {0}, number_available {0};
+    for (size_t i = 0; i < 256; ++i) {
+        p.fill(input.current_position);
+        d.fill_or_zero(input.current_velocity, 0.9);
+        d.fill_or_zero(input.current_acceleration, 0.8);
+        p.fill(input.target_position);
+        d.fill_or_zero(input.target_velocity, 0.7);
+        d.fill_or_zero(input.target_acceleration, 0.6);
+        l.fill(input.max_velocity, input.target_velocity);
+        l.fill(input.max_acceleration, input.target_acceleration);
+        l.fill(input.max_jerk);
+
+        if (!otg.validate_input<false>(input)) {
+            --i;
+            continue;
+        }
+
+        CAPTURE( input );
+        if (otg_sensitivity.calculate(input, trajectory) != Result::Working) {
+            continue;
+        }
+
+        const auto& independent_sensitivities = otg_sensitivity.calculator.target_calculator.independent_min_duration_sensitivities;
+        const auto& sensitivities = otg_sensitivity.calculator.target_calculator.duration_sensitivities;
+        for (size_t dof = 0; dof < DOFs; ++dof) {
+            number_available += std::isnan(independent_sensitivities[dof].target_position) ? 0 : 1;
+
+            for (size_t parameter = 0; parameter < 6; ++parameter) {
+                for (const std::optional<size_t> independent_dof: {std::optional<size_t>(dof), std::optional<size_t>()}) {
+                    const double expected = analytic(independent_dof ? independent_sensitivities[dof] : sensitivities[dof], parameter);
+                    if (std::isnan(expected)) {
+                        continue;
+                    }
+
+                    const std::array<double, 6> nominal {input.target_position[dof], input.target_velocity[dof], input.target_acceleration[dof], input.max_velocity[dof], input.max_acceleration[dof], input.max_jerk[dof]};
+                    const double h = 1e-6 * std::max(1.0, std::abs(nominal[parameter]));
+
+                    input_perturbed = input;
+                    perturb(input_perturbed, dof, parameter, h);
+                    const double duration_plus = duration(input_perturbed, independent_dof);
+                    perturb(input_perturbed, dof, parameter, -2*h);
+                    const double duration_minus = duration(input_perturbed, independent_dof);
+                    const double duration_center = independent_dof ? trajectory.get_independent_min_durations()[dof] : trajectory.get_duration();
+
+                    // Skip kinks, e.g. when the profile family or the limiting DoF changes within the finite difference
+                    const double forward = (duration_plus - duration_center) / h;
+                    const double backward = (duration_center - duration_minus) / h;
+                    if (std::abs(forward - backward) > 1e-3 * (1.0 + std::abs(forward))) {
+                        continue;
+                    }
+
+                    CAPTURE( dof );
+                    CAPTURE( parameter );
+                    CHECK( expected == doctest::Approx((duration_plus - duration_minus) / (2*h)).epsilon(1e-4).scale(1.0) );
+                    number_checked += 1;
+                }
+            }
+        }
+    }
+
+    CHECK( number_available > 3 * 256 * 9 / 10 );
+    CHECK( number_checked > 3 * 256 * 6 );
+}
+
+TEST_CASE("limit-scale") {
+    const size_t DOFs = 3;
+    RuckigThrow<DOFs> otg {0.005};
+
+    InputParameter<DOFs> input, input_scaled;
+    Trajectory<DOFs> trajectory, trajectory_scaled;
+    double scale;
+
+    // From rest to rest, the duration scales exactly with the inverse factor
+    input.current_position = {0.0, -2.0, 1.0};
+    input.target_position = {1.0, 2.0, -3.0};
+    input.max_velocity = {1.0, 2.0, 3.0};
+    input.max_acceleration = {2.0, 1.0, 4.0};
+    input.max_jerk = {4.0, 3.0, 8.0};
+
+    CHECK( otg.calculate(input, trajectory) == Result::Working );
+    const double min_duration = trajectory.get_duration();
+
+    CHECK( otg.calculate_limit_scale(input, 2 * min_duration, trajectory_scaled, scale) == Result::Working );
+    CHECK( scale == doctest::Approx(0.5) );
+    CHECK( trajectory_scaled.get_duration() == doctest::Approx(2 * min_duration) );
+
+    // A duration that can't be reached keeps the original limits and is reported
+    Ruckig<DOFs> otg_without_throw {0.005};
+    CHECK( otg_without_throw.calculate_limit_scale(input, 0.5 * min_duration, trajectory_scaled, scale) == Result::ErrorSynchronizationCalculation );
+    CHECK( scale == 1.0 );
+    CHECK( trajectory_scaled.get_duration() == doctest::Approx(min_duration) );
+    CHECK_THROWS( otg.calculate_limit_scale(input, 0.5 * min_duration, trajectory_scaled, scale) );
+
+    // The duration lies within a blocked interval of the second DoF at the scale of the first DoF
+    InputParameter<2> input_blocked;
+    Trajectory<2> trajectory_blocked;
+    RuckigThrow<2> otg_blocked;
+    input_blocked.current_position = {-4.0, -2.0};
+    input_blocked.current_velocity = {0.0, 1.0};
+    input_blocked.target_position = {-1.0, 3.0};
+    input_blocked.max_velocity = {3.0, 1.0};
+    input_blocked.max_acceleration = {3.0, 2.0};
+    input_blocked.max_jerk = {1.0, 4.0};
+
+    CHECK( otg_blocked.calculate_limit_scale(input_blocked, 11.0, trajectory_blocked, scale) == Result::Working );
+    CHECK( scale > 0.45 );
+    CHECK( scale < 1.0 );
+    CHECK( trajectory_blocked.get_duration() == doctest::Approx(11.0) );
+
+    // The first DoF alone would reach the target with a scale below 0.42
+    for (size_t dof = 0; dof < 2; ++dof) {
+        input_blocked.max_velocity[dof] *= 0.45;
+        input_blocked.max_acceleration[dof] *= 0.45 * 0.45;
+        input_blocked.max_jerk[dof] *= 0.45 * 0.45 * 0.45;
+    }
+    input_blocked.minimum_duration = 11.0;
+    CHECK( otg_blocked.calculate(input_blocked, trajectory_blocked) == Result::Working );
+    CHECK( otg_blocked.calculator.target_calculator.get_blocks()[0].t_min < 11.0 );
+    CHECK( trajectory_blocked.get_duration() > 11.0 + 1e-6 );
+
+    Randomizer<DOFs, decltype(position_dist)> p { position_dist, seed + 24 };
+    Randomizer<DOFs, decltype(dynamic_dist)> d { dynamic_dist, seed + 25 };
+    Randomizer<DOFs, decltype(limit_dist)> l { limit_dist, seed + 26 };
+    std::uniform_real_distribution<double> factor_dist {1.0, 4.0};
+    std::default_random_engine gen (seed + 27);
+
+    size_t number_minimal {0}, number_scaled {0};
+    for (size_t i = 0; i < 256; ++i) {
+        p.fill(input.current_position);
+        d.fill_or_zero(input.current_velocity, 0.5);
+        d.fill_or_zero(input.current_acceleration, 0.4);
+        p.fill(input.target_position);
+        d.fill_or_zero(input.target_velocity, 0.3);
+        d.fill_or_zero(input.target_acceleration, 0.2);
+        l.fill(input.max_velocity, input.target_velocity);
+        l.fill(input.max_acceleration, input.target_acceleration);
+        l.fill(input.max_jerk);
+
+        if (!otg.validate_input<false>(input) || otg.calculate(input, trajectory) != Result::Working) {
+            --i;
+            continue;
+        }
+
+        CAPTURE( input );
+        const double duration = factor_dist(gen) * trajectory.get_duration();
+        const Result result = otg_without_throw.calculate_limit_scale(input, duration, trajectory_scaled, scale);
+        CHECK( 0.0 < scale );
+        CHECK( scale <= 1.0 );
+        if (scale == 1.0) {
+            CHECK( (result == Result::Working || result == Result::ErrorSynchronizationCalculation) );
+            if (result == Result::Working) {
+                CHECK( trajectory_scaled.get_duration() == doctest::Approx(duration) );
+            }
+            continue;
+        }
+
+        CHECK( result == Result::Working );
+        CHECK( trajectory_scaled.get_duration() == doctest::Approx(duration) );
+
+        // The scale is minimal: slightly smaller limits don't reach the target at the duration anymore
+        input_scaled = input;
+        const double smaller_scale = scale * (1 - 1e-6);
+        for (size_t dof = 0; dof < DOFs; ++dof) {
+            input_scaled.max_velocity[dof] *= smaller_scale;
+            input_scaled.max_acceleration[dof] *= smaller_scale * smaller_scale;
+            input_scaled.max_jerk[dof] *= smaller_scale * smaller_scale * smaller_scale;
+        }
+        input_scaled.minimum_duration = duration;
+        if (otg.validate_input<false>(input_scaled) && otg.calculate(input_scaled, trajectory) == Result::Working) {
+            number_minimal += (trajectory.get_duration() > duration * (1 + 1e-9)) ? 1 : 0;
+            ++number_scaled;
+        }
+    }
+
+    // Except if a blocked interval moves over the duration with increasing scale
+    CHECK( number_minimal > number_scaled * 99 / 100 );
+}
+
+TEST_CASE("synchronization-groups") {
+    RuckigThrow<4> otg {0.005};
+    RuckigThrow<2> otg_group {0.005};
+
+    InputParameter<4> input;
+    InputParameter<2> input_first, input_second;
+    Trajectory<4> trajectory;
+    Trajectory<2> trajectory_first, trajectory_second;
+
+    Randomizer<4, decltype(position_dist)> p { position_dist, seed + 28 };
+    Randomizer<4, decltype(dynamic_dist)> d { dynamic_dist, seed + 29 };
+    Randomizer<4, decltype(limit_dist)> l { limit_dist, seed + 30 };
+
+    input.per_dof_synchronization_group = {0, 1, 0, 1};
+
+    for (size_t i = 0; i < 256; ++i) {
+        p.fill(input.current_position);
+        d.fill_or_zero(input.current_velocity, 0.9);
+        d.fill_or_zero(input.current_acceleration, 0.8);
+        p.fill(input.target_position);
+        d.fill_or_zero(input.target_velocity, 0.7);
+        d.fill_or_zero(input.target_acceleration, 0.6);
+        l.fill(input.max_velocity, input.target_velocity);
+        l.fill(input.max_acceleration, input.target_acceleration);
+        l.fill(input.max_jerk);
+        input.synchronization = (i % 2 == 0) ? Synchronization::Time : Synchronization::Phase;
+        input.duration_discretization = (i % 3 == 0) ? DurationDiscretization::Discrete : DurationDiscretization::Continuous;
+
+        if (!otg.validate_input<false>(input)) {
+            --i;
+            continue;
+        }
+
+        // The same result as separate instances per group
+        for (size_t group = 0; group < 2; ++group) {
+            auto& input_group = (group == 0) ? input_first : input_second;
+            for (size_t dof = 0; dof < 2; ++dof) {
+                const size_t input_dof = 2 * dof + group;
+                input_group.current_position[dof] = input.current_position[input_dof];
+                input_group.current_velocity[dof] = input.current_velocity[input_dof];
+                input_group.current_acceleration[dof] = input.current_acceleration[input_dof];
+                input_group.target_position[dof] = input.target_position[input_dof];
+                input_group.target_velocity[dof] = input.target_velocity[input_dof];
+                input_group.target_acceleration[dof] = input.target_acceleration[input_dof];
+                input_group.max_velocity[dof] = input.max_velocity[input_dof];
+                input_group.max_acceleration[dof] = input.max_acceleration[input_dof];
+                input_group.max_jerk[dof] = input.max_jerk[input_dof];
+            }
+            input_group.synchronization = input.synchronization;
+            input_group.duration_discretization = input.duration_discretization;
+        }
+
+        CAPTURE( input );
+        const Result result = otg.calculate(input, trajectory);
+        const Result result_first = otg_group.calculate(input_first, trajectory_first);
+        const Result result_second = otg_group.calculate(input_second, trajectory_second);
+        CHECK( result == ((result_first != Result::Working) ? result_first : result_second) );
+        if (result != Result::Working) {
+            continue;
+        }
+
+        const auto group_durations = trajectory.get_group_durations();
+        CHECK( group_durations[0] == doctest::Approx(trajectory_first.get_duration()) );
+        CHECK( group_durations[1] == doctest::Approx(trajectory_second.get_duration()) );
+        CHECK( group_durations[2] == group_durations[0] );
+        CHECK( group_durations[3] == group_durations[1] );
+        CHECK( trajectory.get_duration() == std::max(group_durations[0], group_durations[1]) );
+
+        // The synchronization of the input is restored after the groups
+        for (size_t dof = 0; dof < 4; ++dof) {
+            CHECK( otg.calculator.target_calculator.limit_set.synchronization[dof] == input.synchronization );
+        }
+
+        for (const double time: {0.3 * group_durations[0], 0.7 * group_durations[1], trajectory.get_duration()}) {
+            std::array<double, 4> new_position, new_velocity, new_acceleration;
+            std::array<double, 2> new_position_first, new_position_second, new_velocity_first, new_velocity_second, new_acceleration_first, new_acceleration_second;
+            trajectory.at_time(time, new_position, new_velocity, new_acceleration);
+            trajectory_first.at_time(time, new_position_first, new_velocity_first, new_acceleration_first);
+            trajectory_second.at_time(time, new_position_second, new_velocity_second, new_acceleration_second);
+            for (size_t dof = 0; dof < 2; ++dof) {
+                CHECK( new_position[2 * dof] == doctest::Approx(new_position_first[dof]) );
+                CHECK( new_position[2 * dof + 1] == doctest::Approx(new_position_second[dof]) );
+                CHECK( new_velocity[2 * dof] == doctest::Approx(new_velocity_first[dof]) );
+                CHECK( new_velocity[2 * dof + 1] == doctest::Approx(new_velocity_second[dof]) );
+            }
+        }
+    }
+}
+
+TEST_CASE("coordinator") {
+    RuckigThrow<5> otg {0.005};
+    RuckigThrow<2> otg_first {0.005};
+    RuckigThrow<DynamicDOFs> otg_second {3, 0.005};
+
+    InputParameter<5> input;
+    InputParameter<2> input_first;
+    InputParameter<DynamicDOFs> input_second {3};
+    Trajectory<5> trajectory;
+    Trajectory<2> trajectory_first;
+    Trajectory<DynamicDOFs> trajectory_second {3};
+
+    Randomizer<5, decltype(position_dist)> p { position_dist, seed + 31 };
+    Randomizer<5, decltype(dynamic_dist)> d { dynamic_dist, seed + 32 };
+    Randomizer<5, decltype(limit_dist)> l { limit_dist, seed + 33 };
+
+    for (size_t i = 0; i < 256; ++i) {
+        p.fill(input.current_position);
+        d.fill_or_zero(input.current_velocity, 0.9);
+        d.fill_or_zero(input.current_acceleration, 0.8);
+        p.fill(input.target_position);
+        d.fill_or_zero(input.target_velocity, 0.7);
+        d.fill_or_zero(input.target_acceleration, 0.6);
+        l.fill(input.max_velocity, input.target_velocity);
+        l.fill(input.max_acceleration, input.target_acceleration);
+        l.fill(input.max_jerk);
+
+        if (!otg.validate_input<false>(input)) {
+            --i;
+            continue;
+        }
+
+        // Split the DoFs onto two instances with different DoFs and vector types
+        for (size_t dof = 0; dof < 5; ++dof) {
+            auto assign = [&](auto& input_part, size_t part_dof) {
+                input_part.current_position[part_dof] = input.current_position[dof];
+                input_part.current_velocity[part_dof] = input.current_velocity[dof];
+                input_part.current_acceleration[part_dof] = input.current_acceleration[dof];
+                input_part.target_position[part_dof] = input.target_position[dof];
+                input_part.target_velocity[part_dof] = input.target_velocity[dof];
+                input_part.target_acceleration[part_dof] = input.target_acceleration[dof];
+                input_part.max_velocity[part_dof] = input.max_velocity[dof];
+                input_part.max_acceleration[part_dof] = input.max_acceleration[dof];
+                input_part.max_jerk[part_dof] = input.max_jerk[dof];
+            };
+            if (dof < 2) {
+                assign(input_first, dof);
+            } else {
+                assign(input_second, dof - 2);
+            }
+        }
+
+        CAPTURE( input );
+        const Result result = otg.calculate(input, trajectory);
+        const Result result_coordinated = Coordinator::calculate(std::tie(otg_first, input_first, trajectory_first), std::tie(otg_second, input_second, trajectory_second));
+        CHECK( result == result_coordinated );
+        if (result != Result::Working) {
+            continue;
+        }
+
+        // The common duration is the one of a single instance with all DoFs
+        CHECK( trajectory_first.get_duration() == doctest::Approx(trajectory.get_duration()) );
+        CHECK( trajectory_second.get_duration() == doctest::Approx(trajectory.get_duration()) );
+
+        std::array<double, 5> new_position;
+        std::array<double, 2> new_position_first;
+        std::vector<double> new_position_second (3);
+        trajectory.at_time(trajectory.get_duration(), new_position);
+        trajectory_first.at_time(trajectory_first.get_duration(), new_position_first);
+        trajectory_second.at_time(trajectory_second.get_duration(), new_position_second);
+        for (size_t dof = 0; dof < 5; ++dof) {
+            CHECK( new_position[dof] == doctest::Approx(input.target_position[dof]) );
+            CHECK( ((dof < 2) ? new_position_first[dof] : new_position_second[dof - 2]) == doctest::Approx(input.target_position[dof]) );
+        }
+    }
+
+    // Step 2 for a given duration requires the input of the last Step 1
+    CHECK( otg_first.calculate_step1(input_first, trajectory_first) == Result::Working );
+    const double duration = std::max(otg_first.get_blocks()[0].t_min, otg_first.get_blocks()[1].t_min);
+    input_first.target_position[0] += 0.1;
+    CHECK_THROWS( otg_first.calculate_step2(input_first, trajectory_first, duration) );
+}
+
+TEST_CASE("retime") {
+    const size_t DOFs = 3;
+    Ruckig<DOFs> otg {0.005};
+    Ruckig<DOFs> otg_minimum_duration {0.005};
+
+    InputParameter<DOFs> input;
+    Trajectory<DOFs> trajectory, trajectory_minimum_duration;
+
+    Randomizer<DOFs, decltype(position_dist)> p { position_dist, seed + 34 };
+    Randomizer<DOFs, decltype(dynamic_dist)> d { dynamic_dist, seed + 35 };
+    Randomizer<DOFs, decltype(limit_dist)> l { limit_dist, seed + 36 };
+
+    size_t number_blocked {0};
+    for (size_t i = 0; i < 256; ++i) {
+        p.fill(input.current_position);
+        d.fill_or_zero(input.current_velocity, 0.9);
+        d.fill_or_zero(input.current_acceleration, 0.8);
+        p.fill(input.target_position);
+        d.fill_or_zero(input.target_velocity, 0.7);
+        d.fill_or_zero(input.target_acceleration, 0.6);
+        l.fill(input.max_velocity, input.target_velocity);
+        l.fill(input.max_acceleration, input.target_acceleration);
+        l.fill(input.max_jerk);
+        input.minimum_duration = std::nullopt;
+
+        if (!otg.validate_input<false>(input) || otg.calculate(input, trajectory) != Result::Working) {
+            --i;
+            continue;
+        }
+
+        CAPTURE( input );
+        const double duration = trajectory.get_duration();
+        CHECK( otg.retime(input, trajectory, 0.5 * duration) == Result::ErrorSynchronizationCalculation );
+
+        // Durations within a blocked interval are rejected
+        const auto blocks = otg.get_blocks();
+        for (size_t dof = 0; dof < DOFs; ++dof) {
+            if (blocks[dof].a) {
+                CHECK( otg.retime(input, trajectory, (blocks[dof].a->left + blocks[dof].a->right) / 2) == Result::ErrorSynchronizationCalculation );
+                number_blocked += 1;
+            }
+        }
+
+        const double new_duration = 1.5 * duration;
+        bool is_blocked {false};
+        for (size_t dof = 0; dof < DOFs; ++dof) {
+            is_blocked |= blocks[dof].is_blocked(new_duration);
+        }
+        if (is_blocked) {
+            continue;
+        }
+
+        // The same result as a full calculation with the minimum duration
+        input.minimum_duration = new_duration;
+        CHECK( otg.retime(input, trajectory, new_duration) == Result::Working );
+        CHECK( otg_minimum_duration.calculate(input, trajectory_minimum_duration) == Result::Working );
+        CHECK( trajectory.get_duration() == doctest::Approx(new_duration) );
+        CHECK( trajectory_minimum_duration.get_duration() == doctest::Approx(new_duration) );
+
+        for (const double time: {0.25 * new_duration, 0.5 * new_duration, new_duration}) {
+            std::array<double, DOFs> new_position, new_position_minimum_duration;
+            trajectory.at_time(time, new_position);
+            trajectory_minimum_duration.at_time(time, new_position_minimum_duration);
+            for (size_t dof = 0; dof < DOFs; ++dof) {
+                CHECK( new_position[dof] == doctest::Approx(new_position_minimum_duration[dof]) );
+            }
+        }
+    }
+
+    CHECK( number_blocked > 0 );
+
+    // Another calculation in between replaces the blocks of the input
+    input.minimum_duration = std::nullopt;
+    CHECK( otg.calculate(input, trajectory) == Result::Working );
+    const double duration = trajectory.get_duration();
+    InputParameter<DOFs> other_input = input;
+    other_input.target_position[0] += 0.5;
+    CHECK( otg.calculate(other_input, trajectory_minimum_duration) == Result::Working );
+    CHECK( otg.retime(input, trajectory, 2 * duration) == Result::ErrorInvalidInput );
+
+    double scale;
+    CHECK( otg.calculate(input, trajectory) == Result::Working );
+    CHECK( otg.calculate_limit_scale(input, 2 * duration, trajectory_minimum_duration, scale) == Result::Working );
+    CHECK( otg.retime(input, trajectory, 2 * duration) == Result::ErrorInvalidInput );
+
+    CHECK( otg.calculate(input, trajectory) == Result::Working );
+    CHECK( otg.retime(input, trajectory, 2 * duration) != Result::ErrorInvalidInput );
+}
+
+TEST_CASE("update-tolerance") {
+    RuckigThrow<3> otg {0.005};
+    InputParameter<3> input;
+    OutputParameter<3> output;
+
+    input.current_position = {0.0, -2.0, 1.0};
+    input.target_position = {1.0, 2.0, -3.0};
+    input.max_velocity = {1.0, 2.0, 3.0};
+    input.max_acceleration = {2.0, 1.0, 4.0};
+    input.max_jerk = {4.0, 3.0, 8.0};
+
+    otg.position_tolerance = {1e-4, 1e-4, 1e-4};
+    otg.velocity_tolerance = {1e-3, 1e-3, 1e-3};
+
+    // Small measurement noise keeps the trajectory
+    CHECK( otg.update(input, output) == Result::Working );
+    CHECK( output.new_calculation );
+    const double duration = output.trajectory.get_duration();
+
+    std::array<double, 3> last_position;
+    for (size_t i = 0; i < 100; ++i) {
+        output.pass_to_input(input);
+        last_position = output.new_position;
+        input.current_position[0] += (i % 2 == 0) ? 5e-5 : -5e-5;
+        input.current_velocity[1] += (i % 2 == 0) ? -5e-4 : 5e-4;
+
+        CHECK( otg.update(input, output) == Result::Working );
+        CHECK_FALSE( output.new_calculation );
+    }
+    CHECK( otg.tolerated_update_counter == 100 );
+    CHECK( output.trajectory.get_duration() == duration );
+
+    // Continuous along the predicted state
+    CHECK( std::abs(output.new_position[0] - last_position[0]) < 0.01 );
+
+    // The acceleration needs to be equal without tolerance
+    output.pass_to_input(input);
+    input.current_acceleration[2] += 1e-9;
+    CHECK( otg.update(input, output) == Result::Working );
+    CHECK( output.new_calculation );
+    CHECK( otg.tolerated_update_counter == 100 );
+
+    // Deviations beyond the tolerance or changed targets lead to a new calculation
+    output.pass_to_input(input);
+    input.current_position[0] += 1e-3;
+    CHECK( otg.update(input, output) == Result::Working );
+    CHECK( output.new_calculation );
+
+    output.pass_to_input(input);
+    input.current_position[0] += 1e-5;
+    input.target_position[0] += 1e-5;
+    CHECK( otg.update(input, output) == Result::Working );
+    CHECK( output.new_calculation );
+    CHECK( otg.tolerated_update_counter == 100 );
+
+    otg.reset();
+    CHECK( otg.tolerated_update_counter == 0 );
+}
+
+TEST_CASE("trajectory-buffer") {
+    const size_t DOFs = 3;
+    const double delta_time {0.001};
+    const size_t number_of_cycles {200000}, horizon_cycles {100};
+
+    TrajectoryBuffer<DOFs> buffer;
+    std::atomic<size_t> cycle {0};
+    std::atomic<bool> is_finished {false};
+
+    // Planning thread: replan to random targets from the predicted state at a future cycle
+    size_t number_published {0};
+    std::thread planner([&] {
+        RuckigThrow<DOFs> otg;
+        InputParameter<DOFs> input;
+        input.max_velocity = {2.0, 2.0, 2.0};
+        input.max_acceleration = {4.0, 4.0, 4.0};
+        input.max_jerk = {20.0, 20.0, 20.0};
+
+        Randomizer<DOFs, decltype(position_dist)> p { position_dist, seed + 37 };
+        while (!is_finished.load()) {
+            if (buffer.is_pending()) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            p.fill(input.target_position);
+            if (buffer.plan(otg, input, (cycle.load() + horizon_cycles) * delta_time) == Result::Working) {
+                number_published += 1;
+            }
+        }
+    });
+
+    // Real-time thread: sample the current trajectory and switch at the start time of new ones
+    size_t number_switches {0}, number_continuous_switches {0};
+    std::array<double, DOFs> position, velocity, acceleration, new_position, new_velocity, new_acceleration;
+    for (size_t i = 0; i < number_of_cycles; ++i) {
+        const double time = i * delta_time;
+        cycle.store(i);
+
+        const bool had_trajectory = buffer.has_trajectory();
+        if (had_trajectory) {
+            buffer.at_time(time, position, velocity, acceleration);
+        }
+
+        if (buffer.update(time)) {
+            number_switches += 1;
+
+            // Continuity holds if the switch happens exactly at the start time (and not late)
+            if (had_trajectory && buffer.get_start_time() == time) {
+                buffer.at_time(time, new_position, new_velocity, new_acceleration);
+                for (size_t dof = 0; dof < DOFs; ++dof) {
+                    CHECK( new_position[dof] == doctest::Approx(position[dof]) );
+                    CHECK( new_velocity[dof] == doctest::Approx(velocity[dof]) );
+                    CHECK( new_acceleration[dof] == doctest::Approx(acceleration[dof]) );
+                }
+                number_continuous_switches += 1;
+            }
+        }
+        std::this_thread::yield();
+    }
+
+    is_finished.store(true);
+    planner.join();
+
+    CHECK( number_switches <= number_published );
+    CHECK( number_published <= number_switches + 1 );
+    CHECK( number_continuous_switches > 10 );
+}
+
+TEST_CASE("precompute") {
+    RuckigThrow<3> otg {0.005};
+    RuckigThrow<3> otg_reference {0.005};
+    InputParameter<3> input, predicted_input;
+    OutputParameter<3> output, output_reference;
+
+    input.current_position = {0.0, -2.0, 1.0};
+    input.target_position = {1.0, 2.0, -3.0};
+    input.max_velocity = {1.0, 2.0, 3.0};
+    input.max_acceleration = {2.0, 1.0, 4.0};
+    input.max_jerk = {4.0, 3.0, 8.0};
+    const std::array<double, 3> target_velocity {0.2, -0.1, 0.3};
+
+    // The target moves with constant velocity and is predicted exactly
+    CHECK( otg.update(input, output) == Result::Working );
+    CHECK( otg_reference.update(input, output_reference) == Result::Working );
+    for (size_t i = 0; i < 50; ++i) {
+        output.pass_to_input(input);
+        input.target_position = {input.target_position[0] + 0.005 * target_velocity[0], input.target_position[1] + 0.005 * target_velocity[1], input.target_position[2] + 0.005 * target_velocity[2]};
+        predicted_input = input;
+        predicted_input.target_position = {input.target_position[0] + 0.005 * target_velocity[0], input.target_position[1] + 0.005 * target_velocity[1], input.target_position[2] + 0.005 * target_velocity[2]};
+
+        CHECK( otg.update(input, output) == Result::Working );
+        CHECK( otg_reference.update(input, output_reference) == Result::Working );
+        CHECK( output.new_calculation );
+        CHECK( output.new_position == output_reference.new_position );
+        CHECK( output.trajectory.get_duration() == output_reference.trajectory.get_duration() );
+
+        output.pass_to_input(predicted_input);
+        CHECK( otg.precompute(predicted_input) == Result::Working );
+    }
+    CHECK( otg.precomputed_update_counter == 49 );
+
+    // A mismatching input is calculated regularly
+    output.pass_to_input(input);
+    input.target_position[1] += 1e-3;
+    CHECK( otg.update(input, output) == Result::Working );
+    CHECK( output.new_calculation );
+    CHECK( otg.precomputed_update_counter == 49 );
+
+    // Small deviations of the target state use the precomputed trajectory only within the target tolerances
+    otg.position_tolerance = {1e-4, 1e-4, 1e-4};
+    output.pass_to_input(input);
+    predicted_input = input;
+    predicted_input.target_position[0] += 1e-3;
+    CHECK( otg.precompute(predicted_input) == Result::Working );
+
+    input.target_position[0] += 1e-3 + 5e-5;
+    CHECK( otg.update(input, output) == Result::Working );
+    CHECK( output.new_calculation );
+    CHECK( otg.precomputed_update_counter == 49 );
+
+    otg.target_position_tolerance = {1e-4, 1e-4, 1e-4};
+    output.pass_to_input(input);
+    predicted_input = input;
+    predicted_input.target_position[0] += 1e-3;
+    CHECK( otg.precompute(predicted_input) == Result::Working );
+
+    input.target_position[0] += 1e-3 + 5e-5;
+    CHECK( otg.update(input, output) == Result::Working );
+    CHECK( output.new_calculation );
+    CHECK( otg.precomputed_update_counter == 50 );
+
+    // The precomputed trajectory ends at the predicted target, so the next update replans for the actual target
+    output.pass_to_input(input);
+    CHECK( otg.update(input, output) == Result::Working );
+    CHECK( output.new_calculation );
+    CHECK( otg.precomputed_update_counter == 50 );
+    std::array<double, 3> new_position;
+    output.trajectory.at_time(output.trajectory.get_duration(), new_position);
+    CHECK( new_position[0] == doctest::Approx(input.target_position[0]).epsilon(1e-8) );
+
+    otg.reset();
+    CHECK( otg.precomputed_update_counter == 0 );
+
+    // The predicted input of a target that moves with its target velocity, calculated by another instance
+    RuckigThrow<3> otg_helper {0.005};
+    Trajectory<3> trajectory_helper;
+    otg.position_tolerance = std::nullopt;
+    otg.target_position_tolerance = std::nullopt;
+    input.target_velocity = {0.2, -0.1, 0.3};
+    CHECK( otg.update(input, output) == Result::Working );
+    for (size_t i = 0; i < 10; ++i) {
+        otg.predict_input(input, output, predicted_input);
+        CHECK( otg_helper.calculate(predicted_input, trajectory_helper) == Result::Working );
+        const double duration_helper = trajectory_helper.get_duration();
+        otg.set_precomputed(predicted_input, trajectory_helper);
+
+        input = predicted_input;
+        CHECK( otg.update(input, output) == Result::Working );
+        CHECK( output.new_calculation );
+        CHECK( output.trajectory.get_duration() == duration_helper );
+    }
+    CHECK( otg.precomputed_update_counter == 10 );
+
+    // The precomputation doesn't change the state of the last calculation, e.g. for retime
+    Trajectory<3> trajectory;
+    CHECK( otg.calculate(input, trajectory) == Result::Working );
+    const double min_duration = otg.get_blocks()[0].t_min;
+    otg.predict_input(input, output, predicted_input);
+    predicted_input.target_position[0] += 0.5;
+    CHECK( otg.precompute(predicted_input) == Result::Working );
+    CHECK( otg.get_blocks()[0].t_min == min_duration );
+    CHECK( otg.retime(input, trajectory, 2 * trajectory.get_duration()) != Result::ErrorInvalidInput );
+}
+
+TEST_CASE("equal-dofs") {
+    RuckigThrow<4> otg {0.005};
+    RuckigThrow<4> otg_reference {0.005};
+    otg.calculator.target_calculator.deduplicate_dofs = true;
+
+    InputParameter<4> input;
+    Trajectory<4> trajectory, trajectory_reference;
+
+    Randomizer<4, decltype(position_dist)> p { position_dist, seed + 38 };
+    Randomizer<4, decltype(dynamic_dist)> d { dynamic_dist, seed + 39 };
+    Randomizer<4, decltype(limit_dist)> l { limit_dist, seed + 40 };
+
+    // The third DoF equals the first one, the fourth DoF mirrors the second one
+    auto set_equal_dof = [&](size_t dof, size_t other, double sign) {
+        input.current_position[dof] = sign * input.current_position[other];
+        input.current_velocity[dof] = sign * input.current_velocity[other];
+        input.current_acceleration[dof] = sign * input.current_acceleration[other];
+        input.target_position[dof] = sign * input.target_position[other];
+        input.target_velocity[dof] = sign * input.target_velocity[other];
+        input.target_acceleration[dof] = sign * input.target_acceleration[other];
+        input.max_velocity[dof] = input.max_velocity[other];
+        input.max_acceleration[dof] = input.max_acceleration[other];
+        input.max_jerk[dof] = input.max_jerk[other];
+    };
+
+    for (size_t i = 0; i < 256; ++i) {
+        p.fill(input.current_position);
+        d.fill_or_zero(input.current_velocity, 0.9);
+        d.fill_or_zero(input.current_acceleration, 0.8);
+        p.fill(input.target_position);
+        d.fill_or_zero(input.target_velocity, 0.7);
+        d.fill_or_zero(input.target_acceleration, 0.6);
+        l.fill(input.max_velocity, input.target_velocity);
+        l.fill(input.max_acceleration, input.target_acceleration);
+        l.fill(input.max_jerk);
+        set_equal_dof(2, 0, 1.0);
+        set_equal_dof(3, 1, -1.0);
+        input.synchronization = (i % 2 == 0) ? Synchronization::Time : Synchronization::Phase;
+        input.duration_discretization = (i % 3 == 0) ? DurationDiscretization::Discrete : DurationDiscretization::Continuous;
+
+        if (!otg.validate_input<false>(input)) {
+            --i;
+            continue;
+        }
+
+        CAPTURE( input );
+        const Result result = otg.calculate(input, trajectory);
+        CHECK( result == otg_reference.calculate(input, trajectory_reference) );
+        if (result != Result::Working) {
+            continue;
+        }
+
+        CHECK( trajectory.get_duration() == doctest::Approx(trajectory_reference.get_duration()) );
+        CHECK( trajectory.get_independent_min_durations()[2] == trajectory.get_independent_min_durations()[0] );
+        CHECK( trajectory.get_independent_min_durations()[3] == doctest::Approx(trajectory_reference.get_independent_min_durations()[3]) );
+
+        std::array<double, 4> new_position, new_velocity, new_acceleration, reference_position, reference_velocity, reference_acceleration;
+        for (const double time: {0.3 * trajectory.get_duration(), 0.7 * trajectory.get_duration(), trajectory.get_duration()}) {
+            trajectory.at_time(time, new_position, new_velocity, new_acceleration);
+            trajectory_reference.at_time(time, reference_position, reference_velocity, reference_acceleration);
+            CHECK( new_position[2] == new_position[0] );
+            CHECK( new_position[3] == -new_position[1] );
+            CHECK( new_position[3] == doctest::Approx(reference_position[3]) );
+            CHECK( new_velocity[3] == doctest::Approx(reference_velocity[3]) );
+        }
+        CHECK( array_eq(new_position, input.target_position) );
+    }
+}
+
+TEST_CASE("adaptive-family-order") {
+    const size_t DOFs = 3;
+    RuckigThrow<DOFs> otg {0.005};
+    RuckigThrow<DOFs> otg_adaptive {0.005};
+    otg_adaptive.calculator.target_calculator.adaptive_family_order = true;
+
+    InputParameter<DOFs> input;
+    Trajectory<DOFs> trajectory, trajectory_adaptive;
+
+    Randomizer<DOFs, decltype(position_dist)> p { position_dist, seed + 41 };
+    Randomizer<DOFs, decltype(dynamic_dist)> d { dynamic_dist, seed + 42 };
+    Randomizer<DOFs, decltype(limit_dist)> l { limit_dist, seed + 43 };
+
+    size_t number_different {0};
+    for (size_t i = 0; i < 1024; ++i) {
+        p.fill(input.current_position);
+        d.fill_or_zero(input.current_velocity, 0.9);
+        d.fill_or_zero(input.current_acceleration, 0.8);
+        p.fill(input.target_position);
+        d.fill_or_zero(input.target_velocity, 0.3);
+        d.fill_or_zero(input.target_acceleration, 0.2);
+        l.fill(input.max_velocity, input.target_velocity);
+        l.fill(input.max_acceleration, input.target_acceleration);
+        l.fill(input.max_jerk);
+
+        if (!otg.validate_input<false>(input)) {
+            --i;
+            continue;
+        }
+
+        CAPTURE( input );
+        const Result result = otg.calculate(input, trajectory);
+        CHECK( result == otg_adaptive.calculate(input, trajectory_adaptive) );
+        if (result != Result::Working) {
+            continue;
+        }
+
+        CHECK( trajectory_adaptive.get_duration() == trajectory.get_duration() );
+
+        std::array<double, DOFs> new_position, new_velocity, new_acceleration;
+        trajectory_adaptive.at_time(trajectory_adaptive.get_duration(), new_position, new_velocity, new_acceleration);
+        CHECK( array_eq(new_position, input.target_position) );
+        CHECK( array_eq(new_velocity, input.target_velocity) );
+
+        // Another valid profile with the same duration might be returned
+        std::array<double, DOFs> position, position_adaptive;
+        trajectory.at_time(trajectory.get_duration() / 2, position);
+        trajectory_adaptive.at_time(trajectory.get_duration() / 2, position_adaptive);
+        number_different += array_eq(position, position_adaptive) ? 0 : 1;
+    }
+    CHECK( number_different < 1024 / 100 );
+
+    // The order of attempts is sorted by the number of successes
+    const auto& statistics = otg_adaptive.calculator.target_calculator.family_statistics;
+    CHECK( std::accumulate(statistics.step1_hits.begin(), statistics.step1_hits.end(), size_t {0}) > 0 );
+    CHECK( std::accumulate(statistics.step2_hits.begin(), statistics.step2_hits.end(), size_t {0}) > 0 );
+    for (size_t i = 1; i < FamilyStatistics::step2_families; ++i) {
+        CHECK( statistics.step2_hits[statistics.step2_order[i - 1]] >= statistics.step2_hits[statistics.step2_order[i]] );
+    }
+    CHECK( otg.calculator.target_calculator.family_statistics.step2_hits[0] == 0 );
+}
+
+TEST_CASE("limit-set") {
+    RuckigThrow<3> otg {0.005};
+    InputParameter<3> input;
+    Trajectory<3> trajectory, trajectory_reference;
+
+    input.current_position = {0.0, -2.0, 1.0};
+    input.target_position = {1.0, 0.5, -3.0};
+    input.target_velocity = {0.0, 0.2, -0.1};
+    input.max_velocity = {1.0, 2.0, 1.5};
+    input.max_acceleration = {2.0, 1.0, 3.0};
+    input.max_jerk = {4.0, 3.0, 5.0};
+
+    const auto& limit_set = otg.calculator.target_calculator.limit_set;
+    CHECK( otg.calculate(input, trajectory) == Result::Working );
+    CHECK( limit_set.min_velocity[1] == -2.0 );
+    CHECK( limit_set.min_acceleration[2] == -3.0 );
+    CHECK( limit_set.max_jerk[2] == 5.0 );
+
+    // The limits are resolved again for changed limits
+    input.current_position = {0.5, 0.0, 0.0};
+    input.current_velocity = {0.1, -0.2, 0.0};
+    input.min_acceleration = {-1.0, -0.5, -2.0};
+    input.max_jerk[0] = 2.0;
+    CHECK( otg.calculate(input, trajectory) == Result::Working );
+    CHECK( limit_set.min_acceleration[1] == -0.5 );
+    CHECK( limit_set.max_jerk[0] == 2.0 );
+
+    RuckigThrow<3> otg_reference {0.005};
+    CHECK( otg_reference.calculate(input, trajectory_reference) == Result::Working );
+    CHECK( trajectory.get_duration() == trajectory_reference.get_duration() );
+}
+
 TEST_CASE("random-discrete-3") {
     const size_t DOFs = 3;
     RuckigThrow<DOFs> otg {0.005};